@@ -19,6 +19,7 @@
 #include "cpuServer.h"
 #include "cpuClient.h"
 #include "cpuInstructionCycle.h"
+#include "cpuCore.h"
 
 #include <log.h>
 #include <utils.h>
@@ -26,18 +27,13 @@
 #include <client.h>
 #include <generalConnections.h>
 
-extern int cpuId;
+extern int cpuId; // cpuId del primer núcleo (los demás siguen en orden)
 extern uint32_t tamanioPagina;
 extern uint32_t entradasPorTabla;
 extern uint32_t cantidadNiveles;
-extern uint32_t pid_actual;
-extern uint32_t last_read_size;
+extern uint32_t retardoMemoria;
 
 
-extern uint32_t pc_actual;
-extern bool ciclo_de_instruccion_activo;
-extern sem_t sem_ciclo_instruccion;
 
-extern int connectionSocketDispatchKernel; // Socket para hablar con el dispatch del Kernel desde el execute
 
 #endif
\ No newline at end of file
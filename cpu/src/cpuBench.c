@@ -0,0 +1,255 @@
+#include "cpu.h"
+#include "cpuBench.h"
+#include <malloc.h>
+#include <time.h>
+#include <semaphore.h>
+
+// Microbenchmark del decodificador: decodifica una mezcla de instrucciones de todos los tipos en un ciclo, y mide el tiempo por instrucción
+// y cuánto heap queda en uso antes y después. El decodificador no debe reservar memoria, así que el heap tiene que quedar igual.
+// Uso: ./bin/cpu --bench-decode <iteraciones>
+
+static const char* benchInstructions[] = {
+    "NOOP",
+    "WRITE 0 EJEMPLO_DE_ESCRITURA",
+    "READ 0 20",
+    "GOTO 0",
+    "IO IMPRESORA 25000",
+    "INIT_PROC proceso1 256",
+    "DUMP_MEMORY",
+    "EXIT",
+};
+#define BENCH_INSTRUCTIONS (sizeof(benchInstructions) / sizeof(benchInstructions[0]))
+
+static double elapsedNs(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+// Retorna 0 si el heap en uso no cambió durante el ciclo, o 1 si creció:
+int runDecodeBenchmark(long iterations) {
+    tDecodedInstruction decoded;
+    long checksum = 0;
+
+    // Una vuelta de calentamiento, así lo que reserve la primera llamada a funciones de la libc no se cuenta:
+    for (size_t i = 0; i < BENCH_INSTRUCTIONS; i++)
+        decode(benchInstructions[i], &decoded);
+
+    struct mallinfo2 before = mallinfo2();
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (long n = 0; n < iterations; n++) {
+        decode(benchInstructions[n % BENCH_INSTRUCTIONS], &decoded);
+        checksum += decoded.operation + decoded.total_params;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    struct mallinfo2 after = mallinfo2();
+
+    long heapGrowth = (long)after.uordblks - (long)before.uordblks;
+    log_info(cpuLog, "Decode: %ld instrucciones, %.1f ns por instrucción, heap en uso antes %zu bytes, después %zu bytes (checksum %ld)",
+             iterations, iterations > 0 ? elapsedNs(start, end) / iterations : 0.0, before.uordblks, after.uordblks, checksum);
+
+    if (heapGrowth != 0) {
+        log_error(cpuLog, "Decode: el heap en uso cambió %ld bytes durante el benchmark", heapGrowth);
+        return 1;
+    }
+    return 0;
+}
+
+// Benchmark del ciclo de instrucción: una Memoria falsa en un hilo, conectada por un socketpair, contesta cada fetch con "GOTO 0"
+// (una instrucción que no toca memoria ni espera nada, a diferencia de NOOP, que duerme) hasta completar la cantidad pedida y después con EXIT.
+// Se mide el mismo programa con el esquema anterior (un hilo pide, otro recibe y ejecuta, y se pasan el turno con un semáforo)
+// y con runInstructionCycle, todo en un hilo. Uso: ./bin/cpu --bench-cycle <instrucciones>
+
+typedef struct {
+    int socket;
+    long instructions; // 0: programa sin fin, un ciclo de GOTO de LOOP_LENGTH instrucciones
+} tFakeMemoria;
+
+#define LOOP_LENGTH 8
+
+static void* fakeMemoriaThread(void* voidPointerFakeMemoria) {
+    tFakeMemoria* fake = voidPointerFakeMemoria;
+    long served = 0;
+    uint32_t imageId = 1;
+
+    tPackage* request;
+    while ((request = receivePackage(fake->socket)) != NULL) {
+        if (request->operationCode == CPU_TO_MEMORIA_FETCH_INSTRUCTION) {
+            char loopInstruction[16];
+            char* instruction = ++served < fake->instructions ? "GOTO 0" : "EXIT";
+            if (fake->instructions == 0) {
+                t_list* params = packageToList(request);
+                snprintf(loopInstruction, sizeof(loopInstruction), "GOTO %d", (extractIntElementFromList(params, 1) + 1) % LOOP_LENGTH);
+                list_destroy_and_destroy_elements(params, free);
+                instruction = loopInstruction;
+            }
+            tPackage* response = createPackage(MEMORIA_TO_CPU_SEND_INSTRUCTION);
+            addToPackage(response, instruction, strlen(instruction) + 1);
+            addToPackage(response, &imageId, sizeof(uint32_t));
+            sendPackage(response, fake->socket);
+        }
+        destroyPackage(request);
+    }
+    return NULL;
+}
+
+// Esquema anterior: el hilo de ejecución recibe la instrucción, la decodifica, la ejecuta y le devuelve el turno al que pide:
+static sem_t pingPongTurn;
+
+static void* pingPongExecutorThread(void* voidPointerCore) {
+    core = voidPointerCore;
+    tDecodedInstruction decoded;
+    tPackage* package;
+    while (core->ciclo_de_instruccion_activo && (package = receivePackage(connectionSocketMemory)) != NULL) {
+        t_list* list = packageToList(package);
+        decode(extractStringElementFromList(list, 0), &decoded);
+        execute(&decoded);
+        if (decoded.operation == EXIT_INST)
+            core->ciclo_de_instruccion_activo = false;
+        else if (decoded.operation != GOTO)
+            core->pc_actual++;
+        list_destroy_and_destroy_elements(list, free);
+        destroyPackage(package);
+        sem_post(&pingPongTurn);
+    }
+    return NULL;
+}
+
+static long runPingPongCycle(void) {
+    long executed = 0;
+    pthread_t executor;
+    sem_init(&pingPongTurn, 0, 0);
+    core->ciclo_de_instruccion_activo = true;
+    pthread_create(&executor, NULL, pingPongExecutorThread, core);
+    while (core->ciclo_de_instruccion_activo) {
+        fetch(core->pid_actual, core->pc_actual);
+        sem_wait(&pingPongTurn);
+        executed++;
+    }
+    pthread_join(executor, NULL);
+    sem_destroy(&pingPongTurn);
+    return executed;
+}
+
+// Corre el programa con el esquema indicado y retorna las instrucciones por segundo:
+static double measureCycle(long instructions, bool singleThread, long* executed) {
+    int memoriaPair[2], kernelPair[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, memoriaPair);
+    socketpair(AF_UNIX, SOCK_STREAM, 0, kernelPair);
+
+    tFakeMemoria fake = { memoriaPair[1], instructions };
+    pthread_t memoriaThread;
+    pthread_create(&memoriaThread, NULL, fakeMemoriaThread, &fake);
+
+    connectionSocketMemory = memoriaPair[0];
+    core->connectionSocketDispatchKernel = kernelPair[0]; // el EXIT final se manda acá y nadie lo lee
+    core->pid_actual = 1;
+    core->pc_actual = 0;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    *executed = singleThread ? runInstructionCycle() : runPingPongCycle();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    shutdown(memoriaPair[0], SHUT_RDWR);
+    pthread_join(memoriaThread, NULL);
+    close(memoriaPair[0]);
+    close(memoriaPair[1]);
+    close(kernelPair[0]);
+    close(kernelPair[1]);
+
+    double seconds = elapsedNs(start, end) / 1e9;
+    return seconds > 0 ? *executed / seconds : 0.0;
+}
+
+int runCycleBenchmark(long instructions) {
+    // Sin archivo de config: el ciclo solo consulta las etapas del pipeline, y con GOTO 0 nunca se adelanta un fetch
+    static cpuConfigStruct benchConfig = { .ETAPAS_PIPELINE = 1 };
+    cpuConfig = &benchConfig;
+    // Un solo núcleo, sin TLB ni cachés, y la conexión con Memoria sin multiplexar (como en una CPU de un núcleo)
+    cores_create(1, 0);
+    core = &cores[0];
+    t_log* benchLog = log_create("CPU_BENCH.log", "CPU_BENCH", true, LOG_LEVEL_INFO);
+    long executedBefore = 0, executedAfter = 0;
+
+    double before = measureCycle(instructions, false, &executedBefore);
+    double after = measureCycle(instructions, true, &executedAfter);
+
+    log_info(benchLog, "Ciclo de instrucción con GOTO 0: antes (dos hilos + semáforo) %.0f instrucciones por segundo, después (un hilo) %.0f instrucciones por segundo (x%.2f)",
+             before, after, before > 0 ? after / before : 0.0);
+    log_destroy(benchLog);
+    return executedBefore == instructions && executedAfter == instructions ? 0 : 1;
+}
+
+// Benchmark del código enhebrado: el mismo ciclo sin fin de GOTO (que después de la primera vuelta sale entero de la caché de instrucciones)
+// corre durante el tiempo pedido, hasta que otro hilo lo interrumpe, con el ciclo normal y con el código enhebrado.
+// Uso: ./bin/cpu --bench-threaded <milisegundos>
+
+typedef struct {
+    tCpuCore* core;
+    long milliseconds;
+} tBenchInterrupt;
+
+static void* benchInterruptThread(void* voidPointerParams) {
+    tBenchInterrupt* params = voidPointerParams;
+    core = params->core;
+    usleep(params->milliseconds * 1000);
+    interrupt_request(core->pid_actual);
+    return NULL;
+}
+
+static double measureThreaded(long milliseconds, int blocks, long* executed) {
+    int memoriaPair[2], kernelPair[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, memoriaPair);
+    socketpair(AF_UNIX, SOCK_STREAM, 0, kernelPair);
+
+    tFakeMemoria fake = { memoriaPair[1], 0 };
+    pthread_t memoriaThread;
+    pthread_create(&memoriaThread, NULL, fakeMemoriaThread, &fake);
+
+    connectionSocketMemory = memoriaPair[0];
+    core->connectionSocketDispatchKernel = kernelPair[0]; // el contexto desalojado se manda acá y nadie lo lee
+    core->pid_actual = 1;
+    core->pc_actual = 0;
+    instruction_cache_init(LOOP_LENGTH * 8, false);
+    threaded_code_init(blocks);
+
+    tBenchInterrupt interrupt = { core, milliseconds };
+    pthread_t interruptThread;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&interruptThread, NULL, benchInterruptThread, &interrupt);
+    *executed = runInstructionCycle();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_join(interruptThread, NULL);
+
+    threaded_code_destroy();
+    instruction_cache_destroy();
+    shutdown(memoriaPair[0], SHUT_RDWR);
+    pthread_join(memoriaThread, NULL);
+    close(memoriaPair[0]);
+    close(memoriaPair[1]);
+    close(kernelPair[0]);
+    close(kernelPair[1]);
+
+    double seconds = elapsedNs(start, end) / 1e9;
+    return seconds > 0 ? *executed / seconds : 0.0;
+}
+
+int runThreadedBenchmark(long milliseconds) {
+    static cpuConfigStruct benchConfig = { .ETAPAS_PIPELINE = 1 };
+    cpuConfig = &benchConfig;
+    cores_create(1, 0);
+    core = &cores[0];
+    t_log* benchLog = log_create("CPU_BENCH.log", "CPU_BENCH", true, LOG_LEVEL_INFO);
+    long executedBefore = 0, executedAfter = 0;
+
+    double before = measureThreaded(milliseconds, 0, &executedBefore);
+    double after = measureThreaded(milliseconds, 16, &executedAfter);
+
+    log_info(benchLog, "Ciclo de %d GOTO durante %ld ms: ciclo normal %.0f instrucciones por segundo, código enhebrado %.0f instrucciones por segundo (x%.1f)",
+             LOOP_LENGTH, milliseconds, before, after, before > 0 ? after / before : 0.0);
+    log_destroy(benchLog);
+    return executedBefore > 0 && executedAfter > 0 ? 0 : 1;
+}
@@ -0,0 +1,8 @@
+#ifndef CPU_BENCH_H
+#define CPU_BENCH_H
+
+int runDecodeBenchmark(long iterations);
+int runCycleBenchmark(long instructions);
+int runThreadedBenchmark(long milliseconds);
+
+#endif
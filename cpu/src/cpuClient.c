@@ -1,5 +1,8 @@
 #include "cpu.h"
 #include "cpuClient.h"
+#include "mmu.h"
+#include "cpuInstructionCache.h"
+#include <poll.h>
 
 
 
@@ -10,7 +13,7 @@
 int handshakeFromDispatchToKernel(int connectionSocket){
     tPackage* handshakePackage = createPackage(CPU_DISPATCH_HANDSHAKE);
     
-    addToPackage(handshakePackage, &cpuId, sizeof(int));
+    addToPackage(handshakePackage, &core->cpuId, sizeof(int));
     log_info(cpuLog, "A punto de enviar mensaje de handshake desde CPU Dispatch a kernel.");
     sendPackage(handshakePackage, connectionSocket);
     log_info(cpuLog, "Enviado mensaje de handshake desde CPU Dispatch a kernel.");
@@ -31,7 +34,7 @@ int handshakeFromDispatchToKernel(int connectionSocket){
 int handshakeFromInterruptToKernel(int connectionSocket){
     tPackage* handshakePackage = createPackage(CPU_INTERRUPT_HANDSHAKE);
     
-    addToPackage(handshakePackage, &cpuId, sizeof(int));
+    addToPackage(handshakePackage, &core->cpuId, sizeof(int));
     log_info(cpuLog, "A punto de enviar mensaje de handshake desde CPU Interrupt a kernel.");
     sendPackage(handshakePackage, connectionSocket);
     log_info(cpuLog, "Enviado mensaje de handshake desde CPU Interrupt a kernel.");
@@ -64,6 +67,7 @@ int handshakeFromDispatchToMemoria(int connectionSocket){
     tamanioPagina = extractIntElementFromList(list, 0);
     entradasPorTabla = extractIntElementFromList(list, 1);
     cantidadNiveles = extractIntElementFromList(list, 2);
+    retardoMemoria = list_size(list) > 3 ? extractIntElementFromList(list, 3) : 0;
 
 
 
@@ -76,11 +80,26 @@ int handshakeFromDispatchToMemoria(int connectionSocket){
     list_destroy_and_destroy_elements(list, free);
     list = NULL;
 
+    // Ya se conoce el tamaño de página: después de esto se pueden levantar los núcleos, cada uno con su TLB y su Caché de Páginas
     connectionSocketMemory = connectionSocket;
 
     return receivedCode == MEMORIA_OK;
 }
 
+// Handshake de una conexión extra con Memoria (la del hilo de prefetch): es el mismo que el de CPU Dispatch, pero la configuración
+// de Memoria ya se conoce, así que se descarta:
+int handshakeFromPrefetchToMemoria(int connectionSocket){
+    sendPackage(createPackage(CPU_DISPATCH_HANDSHAKE), connectionSocket);
+
+    tPackage* receivedPackage = receivePackage(connectionSocket);
+    if (!receivedPackage)
+        return 0;
+    tOperationCode receivedCode = receivedPackage->operationCode;
+    destroyPackage(receivedPackage);
+
+    return receivedCode == MEMORIA_OK;
+}
+
 // Función del handshake inicial entre CPU Interrupt y Memoria.
 // El CPU Dispatch envía un paquete que solo tiene el código de operación CPU_INTERRUPT_HANDSHAKE,
 // Si la memoria lo recibió bien, debe contestar con otro paquete que solo tiene el código
@@ -129,16 +148,221 @@ int memory_get_page_table_entry(uint32_t pid, uint32_t table_addr, int level, in
     return entry_content;
 }
 */
-uint64_t memory_get_page_table_entry(uint32_t pid, uint64_t table_addr, int level, int entry_index) {
+// La conexión con Memoria es una sola para todos los núcleos. Memoria contesta cada conexión en orden, así que no hace falta
+// etiquetar los pedidos: cada núcleo se anota en una cola al mandar, bajo el mismo mutex que el envío, y el hilo de la conexión
+// (serverThreadForMemoria) le entrega cada respuesta que llega al primero de la cola. Con un solo núcleo no hay nada que repartir
+// y el núcleo recibe directo del socket, sin pasar por otro hilo.
+static bool memoriaMultiplexed;
+static pthread_mutex_t memoriaSendMutex = PTHREAD_MUTEX_INITIALIZER;
+static t_queue* memoriaWaitingCores;
+static bool memoriaClosed;
+
+void memory_multiplex_init(int cores) {
+    memoriaMultiplexed = cores > 1;
+    if (memoriaMultiplexed)
+        memoriaWaitingCores = queue_create();
+}
+
+bool memory_is_multiplexed(void) {
+    return memoriaMultiplexed;
+}
+
+static void pushResponse(tCpuCore* receiver, tPackage* response) {
+    pthread_mutex_lock(&receiver->memoriaResponsesMutex);
+    queue_push(receiver->memoriaResponses, response);
+    pthread_mutex_unlock(&receiver->memoriaResponsesMutex);
+    sem_post(&receiver->memoriaResponsesReady);
+}
+
+// Ida y vuelta con Memoria: cada pedido anota cuándo salió y cada respuesta saca la marca más vieja, porque llegan en el mismo orden.
+// Si hay más pedidos en vuelo que lugares, el que no entra no se mide:
+static void roundTripSent(void) {
+    tMemoriaRoundTrip* roundTrip = &core->memoriaRoundTrip;
+    if (roundTrip->sent - roundTrip->answered < MEMORIA_ROUND_TRIP_SLOTS)
+        roundTrip->sentNs[roundTrip->sent++ % MEMORIA_ROUND_TRIP_SLOTS] = nanoseconds();
+}
+
+static void roundTripAnswered(void) {
+    tMemoriaRoundTrip* roundTrip = &core->memoriaRoundTrip;
+    if (roundTrip->answered < roundTrip->sent)
+        histogram_record(&roundTrip->latency, nanoseconds() - roundTrip->sentNs[roundTrip->answered++ % MEMORIA_ROUND_TRIP_SLOTS]);
+}
+
+void memory_report_round_trips(void) {
+    tLatencyHistogram* histogram = &core->memoriaRoundTrip.latency;
+    if (histogram->count == 0) return;
+
+    log_info(cpuLog, "CPU %d: %lu pedidos a Memoria. Ida y vuelta: media %.3f ms, p50 <= %.3f ms, p90 <= %.3f ms, p99 <= %.3f ms, máx %.3f ms",
+             core->cpuId, (unsigned long)histogram->count, histogram_mean(histogram) / 1e6, histogram_percentile(histogram, 50) / 1e6,
+             histogram_percentile(histogram, 90) / 1e6, histogram_percentile(histogram, 99) / 1e6, histogram->maxNs / 1e6);
+}
+
+void memory_send(tPackage* request) {
+    roundTripSent();
+    if (!memoriaMultiplexed) {
+        sendPackage(request, connectionSocketMemory);
+        return;
+    }
+
+    pthread_mutex_lock(&memoriaSendMutex);
+    if (memoriaClosed) {
+        // Ya no va a contestar nadie: el pedido se descarta y el núcleo recibe NULL, como con la conexión directa
+        destroyPackage(request);
+        pushResponse(core, NULL);
+    } else {
+        queue_push(memoriaWaitingCores, core);
+        sendPackage(request, connectionSocketMemory);
+    }
+    pthread_mutex_unlock(&memoriaSendMutex);
+}
+
+// Le entrega la respuesta al núcleo que hizo el pedido más viejo sin contestar. Si se cerró la conexión (response NULL),
+// les entrega NULL a todos los que esperan:
+void memory_deliver_response(tPackage* response) {
+    pthread_mutex_lock(&memoriaSendMutex);
+    if (!response) {
+        memoriaClosed = true;
+        while (!queue_is_empty(memoriaWaitingCores))
+            pushResponse(queue_pop(memoriaWaitingCores), NULL);
+    } else if (!queue_is_empty(memoriaWaitingCores)) {
+        pushResponse(queue_pop(memoriaWaitingCores), response);
+    } else {
+        log_warning(cpuLog, "Llegó una respuesta de Memoria (código %d) que no esperaba ningún núcleo.", response->operationCode);
+        destroyPackage(response);
+    }
+    pthread_mutex_unlock(&memoriaSendMutex);
+}
+
+tPackage* memory_receive(void) {
+    if (!memoriaMultiplexed) {
+        tPackage* response = receivePackage(connectionSocketMemory);
+        roundTripAnswered();
+        return response;
+    }
+
+    sem_wait(&core->memoriaResponsesReady);
+    pthread_mutex_lock(&core->memoriaResponsesMutex);
+    tPackage* response = queue_pop(core->memoriaResponses);
+    pthread_mutex_unlock(&core->memoriaResponsesMutex);
+    // La hora del paquete la vio el hilo que reparte las respuestas; el reloj que tiene que avanzar es el de este núcleo
+    if (response)
+        logicalClockObserve(response->timestamp);
+    roundTripAnswered();
+    return response;
+}
+
+// Indica si ya llegó la próxima respuesta para este núcleo (recibirla no bloquearía):
+static bool memoryResponseReady(void) {
+    if (!memoriaMultiplexed)
+        return poll(&(struct pollfd){ .fd = connectionSocketMemory, .events = POLLIN }, 1, 0) > 0;
+
+    int pending;
+    sem_getvalue(&core->memoriaResponsesReady, &pending);
+    return pending > 0;
+}
+
+// Fetch anticipado: puede haber a lo sumo un pedido de instrucción en vuelo mientras se ejecuta la instrucción anterior. Memoria contesta
+// la conexión en orden, así que si en el medio se manda otro pedido (una lectura de la MMU, por ejemplo), primero llega la instrucción:
+// toda recepción pasa por receiveMemoriaResponse, que la guarda aparte hasta que la pida el ciclo. Un fetch descartado (squash) no se
+// espera: su respuesta se tira cuando llega, en la próxima recepción.
+
+// Consume las respuestas de los fetches descartados, que llegan antes que cualquier respuesta pedida después:
+static bool drainSquashedFetches(void) {
+    while (core->pendingFetch.squashed > 0) {
+        tPackage* stale = memory_receive();
+        if (!stale) return false;
+        destroyPackage(stale);
+        core->pendingFetch.squashed--;
+    }
+    return true;
+}
+
+static tPackage* receiveMemoriaResponse(void) {
+    if (!drainSquashedFetches())
+        return NULL;
+
+    if (core->pendingFetch.inFlight && !core->pendingFetch.arrived) {
+        core->pendingFetch.arrived = memory_receive();
+        if (!core->pendingFetch.arrived) {
+            core->pendingFetch.inFlight = false;
+            return NULL;
+        }
+    }
+
+    return memory_receive();
+}
+
+// Pide a Memoria la instrucción (pid, pc) para tenerla cuando termine la instrucción actual:
+void memory_prefetch_instruction(uint32_t pid, uint32_t pc) {
+    if (core->pendingFetch.inFlight)
+        memory_squash_instruction();
+
+    fetch(pid, pc);
+    core->pendingFetch.inFlight = true;
+    core->pendingFetch.pid = pid;
+    core->pendingFetch.pc = pc;
+    core->fetch_pipeline.issued++;
+}
+
+// Descarta el fetch en vuelo (el PC cambió o el proceso deja la CPU):
+void memory_squash_instruction(void) {
+    if (!core->pendingFetch.inFlight) return;
+
+    if (core->pendingFetch.arrived) {
+        destroyPackage(core->pendingFetch.arrived);
+        core->pendingFetch.arrived = NULL;
+    } else {
+        core->pendingFetch.squashed++;
+    }
+    core->pendingFetch.inFlight = false;
+    core->fetch_pipeline.squashed++;
+    log_debug(cpuLog, "PID: %u - Fetch anticipado del PC %u descartado.", core->pendingFetch.pid, core->pendingFetch.pc);
+}
+
+// Devuelve la respuesta de Memoria con la instrucción (pid, pc): la del fetch anticipado si es esa, o si no la pide y la espera.
+// Cada vez que hay que esperar a Memoria cuenta como un ciclo con stall. Retorna NULL si se perdió la conexión:
+tPackage* memory_fetch_instruction(uint32_t pid, uint32_t pc) {
+    if (core->pendingFetch.inFlight && (core->pendingFetch.pid != pid || core->pendingFetch.pc != pc))
+        memory_squash_instruction();
+    if (!drainSquashedFetches())
+        return NULL;
+
+    tPackage* response = core->pendingFetch.arrived;
+    if (core->pendingFetch.inFlight && !response && memoryResponseReady())
+        response = memory_receive();
+
+    if (response) {
+        // La instrucción llegó mientras se ejecutaba la anterior: la latencia del fetch quedó oculta
+        core->fetch_pipeline.hidden++;
+    } else {
+        if (!core->pendingFetch.inFlight)
+            fetch(pid, pc);
+        uint64_t start = nanoseconds();
+        response = memory_receive();
+        core->fetch_pipeline.stallCycles++;
+        core->fetch_pipeline.stallNs += nanoseconds() - start;
+    }
+
+    core->pendingFetch.arrived = NULL;
+    core->pendingFetch.inFlight = false;
+    return response;
+}
+
+// Los pedidos de entradas de tabla y de lectura están partidos en envío y recepción para poder encadenar varios pedidos en la conexión
+// antes de esperar las respuestas. Memoria atiende la conexión en orden, así que las respuestas llegan en el mismo orden.
+// La MMU junta los pedidos independientes en un solo mensaje con memory_batch (más abajo):
+void memory_request_page_table_entry(uint32_t pid, uint64_t table_addr, int level, int entry_index) {
     tPackage* request = createPackage(CPU_TO_MEMORIA_GET_PAGE_TABLE_ENTRY);
     addToPackage(request, &pid, sizeof(uint32_t));
     addToPackage(request, &table_addr, sizeof(uint64_t)); // Enviamos como uint64_t
     addToPackage(request, &level, sizeof(int));
     addToPackage(request, &entry_index, sizeof(int));
 
-    sendPackage(request, connectionSocketMemory);
+    memory_send(request);
+}
 
-    tPackage* response = receivePackage(connectionSocketMemory);
+uint64_t memory_receive_page_table_entry(void) {
+    tPackage* response = receiveMemoriaResponse();
 
     if (!response || response->operationCode != MEMORIA_TO_CPU_PAGE_TABLE_ENTRY) {
         log_error(cpuLog, "Error recibiendo la entrada de la tabla de páginas desde Memoria.");
@@ -155,18 +379,23 @@ uint64_t memory_get_page_table_entry(uint32_t pid, uint64_t table_addr, int leve
     return entry_content;
 }
 
+uint64_t memory_get_page_table_entry(uint32_t pid, uint64_t table_addr, int level, int entry_index) {
+    memory_request_page_table_entry(pid, table_addr, level, entry_index);
+    return memory_receive_page_table_entry();
+}
 
-int memory_read(uint32_t physical_address, uint32_t size, void* buffer_out) {
-    // Esta función ahora será síncrona para simplificar. Pide y espera la respuesta.
+void memory_request_read(uint32_t physical_address, uint32_t size) {
     tPackage* request = createPackage(CPU_TO_MEMORIA_READ);
-    addToPackage(request, &pid_actual, sizeof(uint32_t));
+    addToPackage(request, &core->pid_actual, sizeof(uint32_t));
     addToPackage(request, &physical_address, sizeof(uint32_t));
     addToPackage(request, &size, sizeof(uint32_t));
     
-    sendPackage(request, connectionSocketMemory);
+    memory_send(request);
+}
 
+int memory_receive_read(uint32_t size, void* buffer_out) {
     // Esperamos la respuesta de Memoria
-    tPackage* response = receivePackage(connectionSocketMemory);
+    tPackage* response = receiveMemoriaResponse();
     if (!response || response->operationCode != MEMORIA_TO_CPU_READ_RESPONSE) {
         log_error(cpuLog, "Error recibiendo la respuesta de LECTURA desde Memoria.");
         if(response) destroyPackage(response);
@@ -182,17 +411,23 @@ int memory_read(uint32_t physical_address, uint32_t size, void* buffer_out) {
     return 0; // Éxito
 }
 
+int memory_read(uint32_t physical_address, uint32_t size, void* buffer_out) {
+    // Esta función ahora será síncrona para simplificar. Pide y espera la respuesta.
+    memory_request_read(physical_address, size);
+    return memory_receive_read(size, buffer_out);
+}
+
 int memory_write(uint32_t physical_address, uint32_t size, void* buffer_in) {
     tPackage* request = createPackage(CPU_TO_MEMORIA_WRITE);
-    addToPackage(request, &pid_actual, sizeof(uint32_t));
+    addToPackage(request, &core->pid_actual, sizeof(uint32_t));
     addToPackage(request, &physical_address, sizeof(uint32_t));
     addToPackage(request, &size, sizeof(uint32_t));
     addToPackage(request, buffer_in, size);
     
-    sendPackage(request, connectionSocketMemory);
+    memory_send(request);
 
     // Esperamos el ACK de Memoria
-    tPackage* response = receivePackage(connectionSocketMemory);
+    tPackage* response = receiveMemoriaResponse();
     if (!response || response->operationCode != MEMORIA_TO_CPU_WRITE_ACK) {
         log_error(cpuLog, "Error recibiendo el ACK de ESCRITURA desde Memoria.");
         if(response) destroyPackage(response);
@@ -201,4 +436,80 @@ int memory_write(uint32_t physical_address, uint32_t size, void* buffer_in) {
 
     destroyPackage(response);
     return 0; // Éxito
-}
\ No newline at end of file
+}
+
+static tPackage* createBatchRequest(uint32_t pid, tMemoriaBatchItem* items, int count) {
+    tPackage* request = createPackage(CPU_TO_MEMORIA_BATCH);
+    addToPackage(request, &pid, sizeof(uint32_t));
+    for (int i = 0; i < count; i++) {
+        addToPackage(request, &items[i].kind, sizeof(uint32_t));
+        if (items[i].kind == MEMORIA_BATCH_PAGE_TABLE_ENTRY) {
+            addToPackage(request, &items[i].table, sizeof(uint64_t));
+            addToPackage(request, &items[i].level, sizeof(int));
+            addToPackage(request, &items[i].index, sizeof(int));
+        } else {
+            addToPackage(request, &items[i].address, sizeof(uint32_t));
+            addToPackage(request, &items[i].size, sizeof(uint32_t));
+            if (items[i].kind == MEMORIA_BATCH_WRITE)
+                addToPackage(request, items[i].data, items[i].size);
+        }
+    }
+    return request;
+}
+
+// Completa cada pedido con su respuesta y destruye el paquete:
+static int completeBatch(tPackage* response, tMemoriaBatchItem* items, int count) {
+    if (!response || response->operationCode != MEMORIA_TO_CPU_BATCH_RESPONSE) {
+        log_error(cpuLog, "Error recibiendo la respuesta de %d pedidos juntos desde Memoria.", count);
+        if(response) destroyPackage(response);
+        return -1;
+    }
+
+    t_list* data = packageToList(response);
+    int status = list_size(data) == count ? 0 : -1;
+    for (int i = 0; i < count && status == 0; i++) {
+        if (items[i].kind == MEMORIA_BATCH_PAGE_TABLE_ENTRY)
+            items[i].entry = extractUint64ElementFromList(data, i);
+        else if (items[i].kind == MEMORIA_BATCH_READ)
+            memcpy(items[i].data, list_get(data, i), items[i].size);
+    }
+    list_destroy_and_destroy_elements(data, free);
+    destroyPackage(response);
+    return status;
+}
+
+// Manda count pedidos independientes en un solo mensaje y completa cada uno con su respuesta (ver tMemoriaBatchKind).
+// Retorna 0, o -1 si se perdió la conexión o la respuesta no corresponde:
+int memory_batch(uint32_t pid, tMemoriaBatchItem* items, int count) {
+    memory_send(createBatchRequest(pid, items, count));
+    return completeBatch(receiveMemoriaResponse(), items, count);
+}
+
+// Lo mismo, pero por una conexión propia de quien llama (la del hilo de prefetch), sin pasar por la del núcleo:
+int memory_batch_on(int connectionSocket, uint32_t pid, tMemoriaBatchItem* items, int count) {
+    sendPackage(createBatchRequest(pid, items, count), connectionSocket);
+    return completeBatch(receivePackage(connectionSocket), items, count);
+}
+
+// Escribe varias páginas completas en Memoria con un solo mensaje (lo usa la Caché de Páginas en modo write-back).
+// El paquete lleva el pid, y luego pares [dirección física del marco | contenido de la página]:
+int memory_write_pages(uint32_t pid, uint32_t* physical_addresses, void** contents, int count) {
+    tPackage* request = createPackage(CPU_TO_MEMORIA_WRITE_PAGES);
+    addToPackage(request, &pid, sizeof(uint32_t));
+    for (int i = 0; i < count; i++) {
+        addToPackage(request, &physical_addresses[i], sizeof(uint32_t));
+        addToPackage(request, contents[i], tamanioPagina);
+    }
+
+    memory_send(request);
+
+    tPackage* response = receiveMemoriaResponse();
+    if (!response || response->operationCode != MEMORIA_TO_CPU_WRITE_ACK) {
+        log_error(cpuLog, "Error recibiendo el ACK de la escritura de %d páginas desde Memoria.", count);
+        if(response) destroyPackage(response);
+        return -1;
+    }
+
+    destroyPackage(response);
+    return 0;
+}
@@ -1,6 +1,8 @@
 #ifndef CPU_CLIENT_H
 #define CPU_CLIENT_H
 
+#include "utils.h"
+
 int handshakeFromDispatchToKernel(int connectionSocket);
 
 int handshakeFromInterruptToKernel(int connectionSocket);
@@ -9,10 +11,77 @@ int handshakeFromDispatchToMemoria(int connectionSocket);
 
 int handshakeFromInterruptToMemoria(int connectionSocket);
 
+int handshakeFromPrefetchToMemoria(int connectionSocket);
+
+void memory_multiplex_init(int cores);
+bool memory_is_multiplexed(void);
+void memory_send(tPackage* request);
+tPackage* memory_receive(void);
+void memory_deliver_response(tPackage* response);
+
 // cpu/src/cpuClient.h
 uint64_t memory_get_page_table_entry(uint32_t pid, uint64_t table_addr, int level, int entry_index);
 
+void memory_request_page_table_entry(uint32_t pid, uint64_t table_addr, int level, int entry_index);
+uint64_t memory_receive_page_table_entry(void);
+
+// Contadores del fetch anticipado (pipeline de 2 etapas): cuántos pedidos se adelantaron, cuántos ya habían llegado al necesitarlos,
+// cuántos se descartaron, y cuántos ciclos tuvieron que esperar una instrucción de Memoria y cuánto tiempo en total:
+typedef struct {
+    uint64_t issued;
+    uint64_t hidden;
+    uint64_t squashed;
+    uint64_t stallCycles;
+    uint64_t stallNs;
+} tFetchPipelineStats;
+
+// Fetch anticipado en vuelo del núcleo (a lo sumo uno): a qué instrucción corresponde, su respuesta si ya llegó,
+// y cuántas respuestas de fetches descartados faltan llegar:
+typedef struct {
+    bool inFlight;
+    uint32_t pid;
+    uint32_t pc;
+    tPackage* arrived;
+    int squashed;
+} tPendingFetch;
+
+// Latencia de ida y vuelta de los pedidos a Memoria del núcleo: marcas de envío de los pedidos sin contestar (un anillo, en orden)
+// y el histograma de cuánto tardó cada respuesta, desde el envío hasta que el núcleo la recibe:
+#define MEMORIA_ROUND_TRIP_SLOTS 32
+
+typedef struct {
+    uint64_t sentNs[MEMORIA_ROUND_TRIP_SLOTS];
+    uint64_t sent;
+    uint64_t answered;
+    tLatencyHistogram latency;
+} tMemoriaRoundTrip;
+
+void memory_report_round_trips(void);
+
+tPackage* memory_fetch_instruction(uint32_t pid, uint32_t pc);
+void memory_prefetch_instruction(uint32_t pid, uint32_t pc);
+void memory_squash_instruction(void);
+
 int memory_read(uint32_t physical_address, uint32_t size, void* buffer_out);
+void memory_request_read(uint32_t physical_address, uint32_t size);
+int memory_receive_read(uint32_t size, void* buffer_out);
 int memory_write(uint32_t physical_address, uint32_t size, void* buffer_in);
+int memory_write_pages(uint32_t pid, uint32_t* physical_addresses, void** contents, int count);
+
+// Un pedido de un CPU_TO_MEMORIA_BATCH. Entrada de tabla: table, level e index, y la respuesta queda en entry.
+// Lectura / escritura: address y size, y data es a dónde se copian los datos leídos o de dónde salen los que se escriben:
+typedef struct {
+    tMemoriaBatchKind kind;
+    uint64_t table;
+    int level;
+    int index;
+    uint32_t address;
+    uint32_t size;
+    void* data;
+    uint64_t entry;
+} tMemoriaBatchItem;
+
+int memory_batch(uint32_t pid, tMemoriaBatchItem* items, int count);
+int memory_batch_on(int connectionSocket, uint32_t pid, tMemoriaBatchItem* items, int count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include "cpu.h"
+#include "cpuCore.h"
+#include <sched.h>
+
+__thread tCpuCore* core;
+
+tCpuCore* cores;
+int coreCount;
+
+// Arma los núcleos, con cpuId consecutivos a partir de firstCpuId. Su MMU se arma recién en su hilo (cores_start):
+void cores_create(int count, int firstCpuId) {
+    coreCount = count;
+    cores = calloc(count, sizeof(tCpuCore));
+    for (int i = 0; i < count; i++) {
+        cores[i].index = i;
+        cores[i].cpuId = firstCpuId + i;
+        cores[i].connectionSocketDispatchKernel = -1;
+        cores[i].connectionSocketInterruptKernel = -1;
+        cores[i].memoriaResponses = queue_create();
+        pthread_mutex_init(&cores[i].memoriaResponsesMutex, NULL);
+        pthread_mutex_init(&cores[i].mmuMutex, NULL);
+        sem_init(&cores[i].memoriaResponsesReady, 0, 0);
+    }
+}
+
+// Fija el hilo actual a un procesador, repartiendo los núcleos en orden entre los que haya:
+static void pinCurrentThread(int index) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processors < 1) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % processors, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) != 0)
+        log_warning(cpuLog, "Núcleo %d: no se pudo fijar el hilo al procesador %ld.", index, index % processors);
+}
+
+// Conecta el núcleo con el Kernel (primero interrupt y después dispatch, cada uno con su handshake con el cpuId del núcleo)
+// y levanta el hilo de interrupt. Retorna el socket de dispatch, o -1 si falló alguna conexión:
+static int connectCoreToKernel(void) {
+    int connectionSocket = createConnectionSocket(getCpuConfig()->IP_KERNEL, getCpuConfig()->PUERTO_KERNEL_INTERRUPT);
+    if (connectionSocket == -1 || !handshakeFromInterruptToKernel(connectionSocket)) {
+        log_error(cpuLog, "Núcleo %d (CPU %d): falló la conexión de interrupt con el Kernel.", core->index, core->cpuId);
+        return -1;
+    }
+    core->connectionSocketInterruptKernel = connectionSocket;
+    pthread_create(&core->interruptThread, NULL, serverInterruptThreadForKernel, core);
+    pthread_detach(core->interruptThread);
+
+    connectionSocket = createConnectionSocket(getCpuConfig()->IP_KERNEL, getCpuConfig()->PUERTO_KERNEL_DISPATCH);
+    if (connectionSocket == -1 || !handshakeFromDispatchToKernel(connectionSocket)) {
+        log_error(cpuLog, "Núcleo %d (CPU %d): falló la conexión de dispatch con el Kernel.", core->index, core->cpuId);
+        return -1;
+    }
+    core->connectionSocketDispatchKernel = connectionSocket;
+    return connectionSocket;
+}
+
+// Hilo de un núcleo: arma su MMU y su caché de instrucciones, se registra en el Kernel y atiende su dispatch hasta que se cierra la conexión:
+static void* coreThread(void* voidPointerCore) {
+    core = voidPointerCore;
+    pinCurrentThread(core->index);
+
+    pthread_mutex_lock(&core->mmuMutex);
+    mmu_init();
+    pthread_mutex_unlock(&core->mmuMutex);
+    instruction_cache_init(cpuConfig->ENTRADAS_CACHE_INSTRUCCIONES, strcmp(cpuConfig->RETARDO_CACHE_INSTRUCCIONES, "MEMORIA") == 0);
+    threaded_code_init(cpuConfig->BLOQUES_TRADUCIDOS);
+
+    int connectionSocket = connectCoreToKernel();
+    if (connectionSocket != -1) {
+        log_info(cpuLog, "Núcleo %d registrado en el Kernel como CPU %d.", core->index, core->cpuId);
+        serverDispatchThreadForKernel(core);
+    }
+
+    interrupt_report();
+    memory_report_round_trips();
+    pthread_mutex_lock(&core->mmuMutex);
+    mmu_destroy();
+    pthread_mutex_unlock(&core->mmuMutex);
+    threaded_code_destroy();
+    instruction_cache_destroy();
+    return NULL;
+}
+
+void cores_start(void) {
+    for (int i = 0; i < coreCount; i++) {
+        pthread_create(&cores[i].thread, NULL, coreThread, &cores[i]);
+        pthread_detach(cores[i].thread);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef CPU_CORE_H
+#define CPU_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <commons/collections/queue.h>
+
+#include "mmu.h"
+#include "mmuPrefetch.h"
+#include "cpuInstructionCache.h"
+#include "cpuClient.h"
+#include "cpuInterrupt.h"
+#include "cpuThreadedCode.h"
+#include "cpuTrace.h"
+
+// Núcleo virtual de la CPU: un proceso cpu levanta NUCLEOS núcleos, cada uno con su contexto de ejecución, sus conexiones de dispatch e
+// interrupt con el Kernel (se registra con su propio cpuId) y su MMU con sus cachés. La conexión con Memoria es una sola para todos.
+// Cada núcleo corre en su propio hilo, fijado a un procesador, y ese hilo (y el de su conexión de interrupt) lo ve en la variable core:
+typedef struct {
+    int index;
+    int cpuId;
+
+    // Contexto de ejecución
+    uint32_t pid_actual;
+    uint32_t pc_actual;
+    bool ciclo_de_instruccion_activo;
+    uint32_t last_read_size;
+
+    // Conexiones con el Kernel
+    int connectionSocketDispatchKernel; // Socket para hablar con el dispatch del Kernel desde el execute
+    int connectionSocketInterruptKernel;
+
+    // MMU y cachés del núcleo (cada una tiene su puntero en NULL si está deshabilitada). El núcleo toma mmuMutex mientras ejecuta
+    // cada instrucción del camino normal, y el hilo de shootdown de Memoria lo toma para invalidar (ver serverShootdownThreadForMemoria):
+    pthread_mutex_t mmuMutex;
+    tTlbCache tlb;
+    tPageCacheState page_cache;
+    tWalkCache walk_cache;
+    tPrefetcher prefetcher;
+    tInstructionCache instruction_cache;
+    tThreadedCode threaded;
+
+    // Retardo simulado de las instrucciones ya ejecutadas que el ciclo todavía no esperó
+    uint64_t pendingDelayNs;
+
+    // Interrupciones del Kernel pendientes y latencia hasta devolver el contexto
+    tInterruptState interrupts;
+
+    // Fetch anticipado
+    tPendingFetch pendingFetch;
+    tFetchPipelineStats fetch_pipeline;
+    tMemoriaRoundTrip memoriaRoundTrip;
+
+    // Traza binaria por instrucción (records es NULL si está apagada)
+    tTraceRing trace;
+
+    // Respuestas de Memoria que ya llegaron para este núcleo, en orden (solo con más de un núcleo, ver cpuClient.c)
+    t_queue* memoriaResponses;
+    pthread_mutex_t memoriaResponsesMutex;
+    sem_t memoriaResponsesReady;
+
+    pthread_t thread;
+    pthread_t interruptThread;
+} tCpuCore;
+
+// Núcleo que atiende el hilo actual
+extern __thread tCpuCore* core;
+
+extern tCpuCore* cores;
+extern int coreCount;
+
+void cores_create(int count, int firstCpuId);
+void cores_start(void);
+
+#endif
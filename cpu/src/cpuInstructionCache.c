@@ -0,0 +1,108 @@
+#include "cpu.h"
+#include "cpuInstructionCache.h"
+
+// La caché se llena con cada instrucción que llega de Memoria, y cada una viene con el identificador de la imagen de instrucciones
+// del proceso. Si llega uno distinto al de las entradas guardadas de ese pid, la imagen cambió (por ejemplo, un pid reutilizado)
+// y se invalidan. Cada ráfaga de ejecución arranca con un fetch real: hasta que no llega esa primera instrucción (y se compara su imagen)
+// la caché no devuelve nada, ni al ciclo ni al código enhebrado, así que nunca se ejecuta una instrucción de una imagen vieja.
+
+void instruction_cache_init(int entries, bool keepFetchDelay) {
+    memset(&core->instruction_cache, 0, sizeof(tInstructionCache));
+    if (entries <= 0) {
+        log_info(cpuLog, "Caché de instrucciones deshabilitada.");
+        return;
+    }
+
+    core->instruction_cache.entries = calloc(entries, sizeof(tCachedInstruction));
+    core->instruction_cache.count = entries;
+    core->instruction_cache.keepFetchDelay = keepFetchDelay;
+    log_info(cpuLog, "Caché de instrucciones habilitada con %d entradas (%s el retardo de fetch en los hits).", entries, keepFetchDelay ? "manteniendo" : "sin");
+}
+
+// Al empezar una ráfaga no se sabe si la imagen del proceso sigue siendo la de las entradas guardadas: hasta el primer fetch real no se usan.
+void instruction_cache_begin_burst(void) {
+    core->instruction_cache.imageChecked = false;
+}
+
+static inline tCachedInstruction* instruction_cache_slot(uint32_t pid, uint32_t pc) {
+    uint32_t hash = (pc * 2654435761u) ^ (pid * 0x9E3779B9u);
+    return &core->instruction_cache.entries[(hash ^ (hash >> 16)) % core->instruction_cache.count];
+}
+
+// Devuelve la instrucción ya decodificada, o NULL si no está. En un hit se simula (si así está configurado) el retardo del fetch:
+tDecodedInstruction* instruction_cache_lookup(uint32_t pid, uint32_t pc) {
+    if (!core->instruction_cache.entries || !core->instruction_cache.imageChecked) return NULL;
+
+    tCachedInstruction* entry = instruction_cache_slot(pid, pc);
+    if (!entry->valid || entry->pc != pc || entry->pid != pid) {
+        core->instruction_cache.misses++;
+        return NULL;
+    }
+
+    core->instruction_cache.hits++;
+    log_info(cpuLog, "PID: %u - Caché de instrucciones HIT - PC: %u", pid, pc);
+    if (core->instruction_cache.keepFetchDelay)
+        simulatedSleepMs(retardoMemoria);
+    return &entry->decoded;
+}
+
+// Devuelve la instrucción si está en la caché, sin contar un hit ni simular el retardo (la usa el traductor a código enhebrado):
+tDecodedInstruction* instruction_cache_peek(uint32_t pid, uint32_t pc) {
+    if (!core->instruction_cache.entries) return NULL;
+
+    tCachedInstruction* entry = instruction_cache_slot(pid, pc);
+    return entry->valid && entry->pc == pc && entry->pid == pid ? &entry->decoded : NULL;
+}
+
+// Dice si la instrucción está en la caché, con las mismas condiciones (la usa el pipeline para no pedir lo que ya tiene):
+bool instruction_cache_probe(uint32_t pid, uint32_t pc) {
+    return instruction_cache_peek(pid, pc) != NULL;
+}
+
+// Decodifica la instrucción que llegó de Memoria directo en su entrada de la caché y la devuelve.
+// Si la instrucción no es válida no se guarda, pero se devuelve igual (con operation en UNKNOWN) para que el ciclo siga como antes:
+tDecodedInstruction* instruction_cache_fill(uint32_t pid, uint32_t pc, uint32_t imageId, const char* instruction) {
+    if (!core->instruction_cache.entries) return NULL;
+
+    tCachedInstruction* entry = instruction_cache_slot(pid, pc);
+    entry->valid = decode(instruction, &entry->decoded);
+    entry->pid = pid;
+    entry->pc = pc;
+    entry->imageId = imageId;
+    return &entry->decoded;
+}
+
+// Invalida las entradas del pid que no son de la imagen imageId:
+void instruction_cache_check_image(uint32_t pid, uint32_t imageId) {
+    if (!core->instruction_cache.entries) return;
+    core->instruction_cache.imageChecked = true;
+
+    for (int i = 0; i < core->instruction_cache.count; i++) {
+        tCachedInstruction* entry = &core->instruction_cache.entries[i];
+        if (entry->valid && entry->pid == pid && entry->imageId != imageId) {
+            entry->valid = false;
+            core->instruction_cache.invalidations++;
+        }
+    }
+}
+
+void instruction_cache_invalidate_process(uint32_t pid) {
+    if (!core->instruction_cache.entries) return;
+
+    for (int i = 0; i < core->instruction_cache.count; i++) {
+        tCachedInstruction* entry = &core->instruction_cache.entries[i];
+        if (entry->valid && entry->pid == pid) {
+            entry->valid = false;
+            core->instruction_cache.invalidations++;
+        }
+    }
+}
+
+void instruction_cache_destroy(void) {
+    if (!core->instruction_cache.entries) return;
+
+    log_info(cpuLog, "Caché de instrucciones: %lu hits, %lu misses, %lu invalidaciones.", (unsigned long)core->instruction_cache.hits,
+             (unsigned long)core->instruction_cache.misses, (unsigned long)core->instruction_cache.invalidations);
+    free(core->instruction_cache.entries);
+    memset(&core->instruction_cache, 0, sizeof(tInstructionCache));
+}
@@ -0,0 +1,39 @@
+#ifndef CPU_INSTRUCTION_CACHE_H
+#define CPU_INSTRUCTION_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils.h"
+
+// Entrada de la caché de instrucciones: la instrucción (pid, pc) ya decodificada, y la imagen de instrucciones de Memoria de la que salió:
+typedef struct {
+    uint32_t pid;
+    uint32_t pc;
+    uint32_t imageId;
+    bool valid;
+    tDecodedInstruction decoded;
+} tCachedInstruction;
+
+// Caché de instrucciones decodificadas, de mapeo directo por hash de (pid, pc). Un hit evita el fetch a Memoria y el decode;
+// si keepFetchDelay está prendido, se espera igual el retardo de Memoria para que los tiempos sean comparables con la caché apagada:
+typedef struct {
+    tCachedInstruction* entries;
+    int count;
+    bool keepFetchDelay;
+    bool imageChecked; // la ráfaga en curso ya comparó la imagen del proceso con la de un fetch real (ver instruction_cache_begin_burst)
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+} tInstructionCache;
+
+void instruction_cache_init(int entries, bool keepFetchDelay);
+void instruction_cache_begin_burst(void);
+tDecodedInstruction* instruction_cache_lookup(uint32_t pid, uint32_t pc);
+bool instruction_cache_probe(uint32_t pid, uint32_t pc);
+tDecodedInstruction* instruction_cache_peek(uint32_t pid, uint32_t pc);
+tDecodedInstruction* instruction_cache_fill(uint32_t pid, uint32_t pc, uint32_t imageId, const char* instruction);
+void instruction_cache_check_image(uint32_t pid, uint32_t imageId);
+void instruction_cache_invalidate_process(uint32_t pid);
+void instruction_cache_destroy(void);
+
+#endif
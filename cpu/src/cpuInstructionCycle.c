@@ -1,18 +1,37 @@
 #include "cpu.h"
 #include "cpuServer.h"
 #include "mmu.h"  
+#include "cpuInstructionCache.h"
 
-// Mapear instrucciones
-tInstructionType mapInstruction (char* instruction) {
-    if (strcmp(instruction, "NOOP") == 0) return NOOP;
-    if (strcmp(instruction, "WRITE") == 0) return WRITE;
-    if (strcmp(instruction, "READ") == 0) return READ;
-    if (strcmp(instruction, "GOTO") == 0) return GOTO;
-    if (strcmp(instruction, "IO") == 0) return IO_INST;
-    if (strcmp(instruction, "INIT_PROC") == 0) return INIT_PROC;
-    if (strcmp(instruction, "DUMP_MEMORY") == 0) return DUMP_MEMORY;
-    if (strcmp(instruction, "EXIT") == 0) return EXIT_INST;
-    return UNKNOWN;
+// Mapear instrucciones con un hash perfecto: (largo + 5 * primera letra + última letra) % 10 da un índice distinto para cada mnemónico,
+// así que alcanza con una comparación para confirmar. Si se agrega una instrucción hay que buscar de nuevo los coeficientes:
+#define MNEMONIC_HASH_SIZE 10
+
+typedef struct {
+    const char* mnemonic;
+    uint8_t length;
+    tInstructionType operation;
+    uint8_t params;        // cantidad exacta de parámetros
+    uint8_t numericParams; // bit i prendido: el parámetro i es un número
+} tMnemonic;
+
+static const tMnemonic mnemonicTable[MNEMONIC_HASH_SIZE] = {
+    [0] = { "DUMP_MEMORY", 11, DUMP_MEMORY, 0, 0x0 },
+    [1] = { "INIT_PROC",    9, INIT_PROC,   2, 0x2 },
+    [2] = { "READ",         4, READ,        2, 0x3 },
+    [3] = { "EXIT",         4, EXIT_INST,   0, 0x0 },
+    [4] = { "NOOP",         4, NOOP,        0, 0x0 },
+    [6] = { "IO",           2, IO_INST,     2, 0x2 },
+    [8] = { "GOTO",         4, GOTO,        1, 0x1 },
+    [9] = { "WRITE",        5, WRITE,       2, 0x1 },
+};
+
+static inline const tMnemonic* mapInstruction(const char* instruction, size_t length) {
+    if (length == 0) return NULL;
+    const tMnemonic* entry = &mnemonicTable[(length + 5 * (uint8_t)instruction[0] + (uint8_t)instruction[length - 1]) % MNEMONIC_HASH_SIZE];
+    if (entry->mnemonic && entry->length == length && memcmp(entry->mnemonic, instruction, length) == 0)
+        return entry;
+    return NULL;
 }
 
 // Funcion para enviar solicitud de instruccion a memoria
@@ -22,21 +41,173 @@ void fetch(int pid, int pc){
     tPackage* request = createPackage(CPU_TO_MEMORIA_FETCH_INSTRUCTION);
     addToPackage(request, &pid, sizeof(int));
     addToPackage(request, &pc, sizeof(int));
-    sendPackage(request, connectionSocketMemory);
+    memory_send(request);
     log_info(cpuLog, "Solicitud de instrucción enviada a Memoria: PID=%d, PC=%d", pid, pc);
-    //serverThreadForMemoria(connectionSocketMemory);
-    void* serverThreadForMemoria(void* voidPointerConnectionSocket);
+}
+
+// Trae la instrucción de (pid_actual, pc_actual) ya decodificada: de la caché de instrucciones si está, o pidiéndola a Memoria y esperando
+// la respuesta en este mismo hilo. Con la caché se decodifica directo en su entrada; si no, en storage (decode no reserva memoria).
+// Retorna NULL si se perdió la conexión con Memoria:
+static tDecodedInstruction* fetchAndDecode(tDecodedInstruction* storage) {
+    tDecodedInstruction* decoded = instruction_cache_lookup(core->pid_actual, core->pc_actual);
+    if (decoded) {
+        trace_flag(TRACE_ICACHE_HIT);
+        return decoded;
+    }
+
+    // Si el fetch anticipado ya pidió esta instrucción se usa esa respuesta; si no, se pide ahora:
+    tPackage* response = memory_fetch_instruction(core->pid_actual, core->pc_actual);
+    if (!response || response->operationCode != MEMORIA_TO_CPU_SEND_INSTRUCTION) {
+        log_error(cpuLog, "PID: %u - Error recibiendo la instrucción del PC %u desde Memoria.", core->pid_actual, core->pc_actual);
+        if (response) destroyPackage(response);
+        return NULL;
+    }
 
+    t_list* list = packageToList(response);
+    char* instruction_string = extractStringElementFromList(list, 0);
+    uint32_t imageId = list_size(list) > 1 ? extractIntElementFromList(list, 1) : 0;
+    log_info(cpuLog, "Instrucción recibida desde Memoria: %s", instruction_string);
+
+    // La imagen 0 es el EXIT que manda Memoria para un PC fuera del proceso: no se guarda ni invalida nada.
+    if (imageId != 0) {
+        instruction_cache_check_image(core->pid_actual, imageId);
+        decoded = instruction_cache_fill(core->pid_actual, core->pc_actual, imageId, instruction_string);
+    }
+    if (!decoded) {
+        decode(instruction_string, storage);
+        decoded = storage;
+    }
+
+    list_destroy_and_destroy_elements(list, free);
+    destroyPackage(response);
+    return decoded;
+}
+
+// Ejecuta la instrucción y avanza el PC (salvo que la instrucción lo haya cambiado, como GOTO):
+static void executeAndAdvance(tDecodedInstruction* decoded) {
+    if (decoded->operation == EXIT_INST) {
+        log_info(cpuLog, "PID: %d - Instrucción EXIT recibida. Finalizando ejecución.", core->pid_actual);
+        core->ciclo_de_instruccion_activo = false;
+        execute(decoded);
+    } else {
+        execute(decoded);
+        // Actualizamos el PC si la instrucción no fue GOTO
+        if (decoded->operation != GOTO) {
+            core->pc_actual++;
+        }
+    }
+}
+
+// Con el pipeline de 2 etapas, apenas se decodifica una instrucción se pide la siguiente, así el fetch viaja mientras se ejecuta la actual:
+// PC+1 después de NOOP, READ y WRITE, y el destino después de un GOTO (es un literal, ya se conoce al decodificar). EXIT y las syscalls
+// no adelantan nada: el proceso deja la CPU. Si igual el PC termina en otro lado, memory_fetch_instruction descarta lo pedido:
+static inline bool continuesSequentially(tInstructionType operation) {
+    return operation == NOOP || operation == READ || operation == WRITE;
+}
+
+static void prefetchNextInstruction(tDecodedInstruction* decoded) {
+    if (cpuConfig->ETAPAS_PIPELINE < 2)
+        return;
+    uint32_t next;
+    if (decoded->operation == GOTO)
+        next = (uint32_t)decoded->args[0];
+    else if (continuesSequentially(decoded->operation))
+        next = core->pc_actual + 1;
+    else
+        return;
+    if (instruction_cache_probe(core->pid_actual, next))
+        return;
+    memory_prefetch_instruction(core->pid_actual, next);
+}
+
+// Espera entero el retardo simulado acumulado (NOOP, o fetches del camino rápido): las instrucciones ya cuentan como ejecutadas,
+// así que su tiempo se paga aunque haya llegado una interrupción, que se atiende recién al terminar (como en el límite de instrucción).
+// En tiempo lógico no hay nada que esperar: el retardo solo adelanta el reloj del núcleo:
+static void payPendingDelay(void) {
+    if (core->pendingDelayNs > 0)
+        simulatedSleepNs(core->pendingDelayNs);
+    core->pendingDelayNs = 0;
+}
+
+// Ciclo de instrucción del proceso en ejecución, todo en el hilo que lo llama: fetch → decode → execute con pedidos síncronos a Memoria,
+// sin pasar por otros hilos, hasta que el proceso deja la CPU (EXIT, una syscall, un SEGMENTATION FAULT, o una interrupción del Kernel atendida entre dos instrucciones). Al terminar loguea cuántas instrucciones por segundo ejecutó la ráfaga.
+// Retorna la cantidad de instrucciones ejecutadas:
+long runInstructionCycle(void) {
+    tDecodedInstruction storage;
+    long executed = 0;
+    tFetchPipelineStats before = core->fetch_pipeline;
+    uint64_t start = nanoseconds();
+    core->ciclo_de_instruccion_activo = true;
+    interrupt_begin_burst();
+    instruction_cache_begin_burst();
+
+    while (core->ciclo_de_instruccion_activo) {
+        // Las rachas de NOOP / GOTO que ya están en la caché de instrucciones van por el código enhebrado (ver cpuThreadedCode.c)
+        uint32_t pc = core->pc_actual;
+        long threaded = threaded_run();
+        if (threaded > 0) {
+            executed += threaded;
+            if (trace_on())
+                trace_commit(core->pid_actual, pc, TRACE_OPCODE_THREADED, threaded);
+        } else {
+            // Mientras dura la instrucción, un shootdown de Memoria espera a que termine para tocar la TLB y la Caché de Páginas
+            pthread_mutex_lock(&core->mmuMutex);
+            uint64_t fetchStart = 0;
+            trace_begin(fetchStart);
+            tDecodedInstruction* decoded = fetchAndDecode(&storage);
+            trace_end(fetchNs, fetchStart);
+            if (!decoded) {
+                pthread_mutex_unlock(&core->mmuMutex);
+                core->ciclo_de_instruccion_activo = false;
+                break;
+            }
+
+            // Si cambió el proceso en ejecución, se bajan a Memoria las páginas modificadas del anterior (caché write-back):
+            page_cache_switch_process(core->pid_actual);
+
+            prefetchNextInstruction(decoded);
+            executeAndAdvance(decoded);
+            if (core->ciclo_de_instruccion_activo)
+                prefetch_lookahead(core->pid_actual, core->pc_actual);
+            pthread_mutex_unlock(&core->mmuMutex);
+            executed++;
+            if (trace_on())
+                trace_commit(core->pid_actual, pc, decoded->operation, 1);
+        }
+
+        payPendingDelay();
+
+        // Límite de instrucción: si el Kernel pidió desalojar, se le devuelve el contexto y se deja la CPU
+        if (core->ciclo_de_instruccion_activo && interrupt_pending()) {
+            interrupt_acknowledge();
+            core->ciclo_de_instruccion_activo = false;
+        }
+    }
+    interrupt_end_burst();
+
+    // El proceso deja la CPU: lo que se haya pedido por adelantado ya no sirve (el fetch en vuelo también lo mira el hilo de shootdown)
+    pthread_mutex_lock(&core->mmuMutex);
+    memory_squash_instruction();
+    pthread_mutex_unlock(&core->mmuMutex);
+
+    double seconds = (nanoseconds() - start) / 1e9;
+    log_info(cpuLog, "PID: %u - Ráfaga terminada: %ld instrucciones en %.3f s (%.0f instrucciones por segundo)",
+             core->pid_actual, executed, seconds, seconds > 0 ? executed / seconds : 0.0);
+    uint64_t stallCycles = core->fetch_pipeline.stallCycles - before.stallCycles;
+    log_info(cpuLog, "PID: %u - Pipeline de fetch: %lu adelantados, %lu a tiempo, %lu descartados; %lu ciclos con stall de fetch (%.3f ms esperando a Memoria)",
+             core->pid_actual, (unsigned long)(core->fetch_pipeline.issued - before.issued), (unsigned long)(core->fetch_pipeline.hidden - before.hidden),
+             (unsigned long)(core->fetch_pipeline.squashed - before.squashed), (unsigned long)stallCycles, (core->fetch_pipeline.stallNs - before.stallNs) / 1e6);
+    return executed;
 }
 
 void requestFreeMemoryMock() {
 
     tPackage* request = createPackage(GET_MEMORIA_FREE_SPACE);
-    sendPackage(request, connectionSocketMemory);
+    memory_send(request);
     log_info(cpuLog, "Envio Consulta de Memoria disponible");
 
     // Recibo respuesta de memoria disponible
-    tPackage* response = receivePackage(connectionSocketMemory);
+    tPackage* response = memory_receive();
     
     if (response && response->operationCode == GET_MEMORIA_FREE_SPACE) {
         t_list* list = packageToList(response);
@@ -53,139 +224,199 @@ void requestFreeMemoryMock() {
 }
 
 
-tDecodedInstruction* decode(char* instruction_string) {
-    tDecodedInstruction* decodedInstruction = malloc(sizeof(tDecodedInstruction));
+static inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
 
-    //! Prueba de escritorio 
-    log_info(cpuLog, "Recibida instrucción para decodificar: '%s'", instruction_string);
+// Convierte un parámetro a entero sin pasar por atoi (que no avisa si el texto no es un número ni si se pasa de rango).
+// Los operandos numéricos son direcciones, tamaños, tiempos o PCs, así que tienen que entrar en un uint32_t:
+static bool parseNumber(const char* text, int64_t* value) {
+    if (*text == '\0') return false;
 
-    char** parts = string_split(instruction_string, " "); // Dividimos la instrucción por espacios
-    
-    //!1 prueba de escritorio
-    log_info(cpuLog, "Instrucción parseada: Operación='%s', Parámetro 1='%s'", parts[0], parts[1]); 
-
-    char* operation_str = parts[0]; // La primera parte es siempre la operación
+    int64_t result = 0;
+    for (; *text; text++) {
+        if (*text < '0' || *text > '9') return false;
+        result = result * 10 + (*text - '0');
+        if (result > UINT32_MAX) return false;
+    }
+    *value = result;
+    return true;
+}
 
-    decodedInstruction->operation = mapInstruction(operation_str); // Mapeamos el string a nuestro enum
+// Decodifica la instrucción en la estructura que pasa quien llama, sin reservar memoria: copia el texto, lo corta en el lugar
+// y convierte los operandos numéricos. Retorna false (y operation queda en UNKNOWN) si la instrucción no es válida:
+bool decode(const char* instruction_string, tDecodedInstruction* decodedInstruction) {
+    decodedInstruction->operation = UNKNOWN;
     decodedInstruction->total_params = 0;
 
-    // Copiamos los parámetros (si los hay)
-    int i = 1;
-    while (parts[i] != NULL) {
-        decodedInstruction->params[decodedInstruction->total_params] = strdup(parts[i]);
-        decodedInstruction->total_params++;
-        i++;
+    size_t length = strnlen(instruction_string, INSTRUCTION_MAX_LENGTH);
+    if (length == INSTRUCTION_MAX_LENGTH) {
+        log_error(cpuLog, "Instrucción demasiado larga (más de %d caracteres)", INSTRUCTION_MAX_LENGTH - 1);
+        return false;
+    }
+    memcpy(decodedInstruction->text, instruction_string, length + 1);
+
+    // Tokenizado en el lugar: cada separador pasa a ser '\0' y se anota dónde empieza cada palabra.
+    char* cursor = decodedInstruction->text;
+    char* mnemonic = NULL;
+    size_t mnemonicLength = 0;
+    while (*cursor) {
+        while (isSeparator(*cursor))
+            *cursor++ = '\0';
+        if (!*cursor)
+            break;
+
+        char* word = cursor;
+        while (*cursor && !isSeparator(*cursor))
+            cursor++;
+
+        if (!mnemonic) {
+            mnemonic = word;
+            mnemonicLength = cursor - word;
+        } else if (decodedInstruction->total_params < INSTRUCTION_MAX_PARAMS) {
+            decodedInstruction->params[decodedInstruction->total_params++] = word;
+        } else {
+            log_error(cpuLog, "Instrucción con más de %d parámetros: '%s'", INSTRUCTION_MAX_PARAMS, instruction_string);
+            return false;
+        }
+    }
+
+    const tMnemonic* entry = mnemonic ? mapInstruction(mnemonic, mnemonicLength) : NULL;
+    if (!entry) {
+        log_error(cpuLog, "Instrucción desconocida: '%s'", instruction_string);
+        return false;
     }
 
-    // Liberamos la memoria usada por string_split
-    // OJO: No libera los punteros que copiamos, solo el array de punteros.
-    for (int j = 0; parts[j] != NULL; j++) {
-        free(parts[j]);
+    if (decodedInstruction->total_params != entry->params) {
+        log_error(cpuLog, "%s lleva %d parámetros y se recibieron %d: '%s'", entry->mnemonic, entry->params, decodedInstruction->total_params, instruction_string);
+        return false;
     }
-    free(parts);
 
-    log_info(cpuLog, "Instrucción decodificada: %d con %d parámetros", decodedInstruction->operation, decodedInstruction->total_params);
-    return decodedInstruction;
+    for (int i = 0; i < decodedInstruction->total_params; i++) {
+        decodedInstruction->args[i] = 0;
+        if ((entry->numericParams & (1 << i)) && !parseNumber(decodedInstruction->params[i], &decodedInstruction->args[i])) {
+            log_error(cpuLog, "El parámetro %d de '%s' no es un número entre 0 y %u", i + 1, instruction_string, UINT32_MAX);
+            return false;
+        }
+    }
+
+    decodedInstruction->operation = entry->operation;
+    return true;
 }
 
 
+// Un acceso fuera del proceso lo termina: igual que en EXIT se descarta lo que la CPU tiene de él, se avisa al Kernel
+// (que lo pasa a EXIT) y se deja la CPU:
+static void segmentationFault(void) {
+    mmu_invalidate_process(core->pid_actual);
+    instruction_cache_invalidate_process(core->pid_actual);
+    sendPackage(createPackage(CPU_DISPATCH_TO_KERNEL_SEG_FAULT), core->connectionSocketDispatchKernel);
+    core->ciclo_de_instruccion_activo = false;
+}
+
+// Syscalls que bloquean o que el Kernel atiende antes de devolver el proceso (IO, INIT_PROC, DUMP_MEMORY): se agrega al paquete el PC
+// de la instrucción siguiente, que es donde retoma el proceso, y se deja la CPU. El Kernel manda el contexto de nuevo cuando corresponda:
+static void returnContextToKernel(tPackage* package) {
+    uint32_t next_pc = core->pc_actual + 1;
+    addToPackage(package, &next_pc, sizeof(uint32_t));
+    sendPackage(package, core->connectionSocketDispatchKernel);
+    core->ciclo_de_instruccion_activo = false;
+}
 
 void execute(tDecodedInstruction* decodedInstruction) {
 
     switch (decodedInstruction->operation){
         case NOOP:
-            log_info(cpuLog, "EMPIEZA NOOP");
-            usleep(2000000);
-            log_info(cpuLog, "TERMINA NOOP");
+            // No se duerme acá: el ciclo espera el retardo acumulado al terminar la instrucción
+            log_info(cpuLog, "PID: %u - Ejecutando: NOOP", core->pid_actual);
+            core->pendingDelayNs += NOOP_DELAY_NS;
             break;
         case READ: {
-            //! Prueba de escritorio
             log_info(cpuLog, "Ejecutando: READ. Parámetros: %s, %s", decodedInstruction->params[0], decodedInstruction->params[1]);
-            // 1. Obtenemos la dirección lógica y el tamaño de la instrucción
-            uint32_t logical_address = atoi(decodedInstruction->params[0]);
-            uint32_t size_to_read = atoi(decodedInstruction->params[1]);
-            uint32_t physical_address;
-
-            // 2. Llamar a MMU para que traduzca
-            tMmuStatus status = translate_address(pid_actual, logical_address, &physical_address);
-
-            if (status == MMU_SEG_FAULT) {
-                // La traducción falló (Page Fault). Informar al Kernel.
-                log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar leer la dirección lógica %u", pid_actual, logical_address);
-                // TODO: Enviar paquete a Kernel con motivo de SEG_FAULT y devolver el PCB.
+            uint32_t logical_address = decodedInstruction->args[0];
+            uint32_t size_to_read = decodedInstruction->args[1];
+
+            // La MMU resuelve TLB, Caché de Páginas y accesos que cruzan páginas. El +1 deja lugar al terminador para loguear el valor:
+            char* data_read = calloc(size_to_read + 1, 1);
+            uint64_t accessStart = 0;
+            uint64_t translatedNs = 0;
+            trace_begin_access(accessStart, translatedNs);
+            tMmuStatus status = mmu_read(logical_address, size_to_read, data_read);
+            trace_end_access(accessStart, translatedNs);
+            if (status != MMU_OK) {
+                log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar leer la dirección lógica %u", core->pid_actual, logical_address);
+                free(data_read);
+                segmentationFault();
                 break;
             }
 
-            // 3. La traducción fue exitosa. Enviamos la DIRECCIÓN FÍSICA a Memoria.
-            log_info(cpuLog, "PID: %u - Acción: LEER - Dir. Lógica: %u -> Dir. Física: %u - Tamaño: %u", 
-                     pid_actual, logical_address, physical_address, size_to_read);
-            
-            tPackage* req = createPackage(CPU_TO_MEMORIA_READ);
-            addToPackage(req, &pid_actual, sizeof(uint32_t));
-            addToPackage(req, &physical_address, sizeof(uint32_t)); // enviar la física!
-            addToPackage(req, &size_to_read, sizeof(uint32_t));
-            sendPackage(req, connectionSocketMemory);
-            
-            // La respuesta de la memoria la maneja el hilo `serverThreadForMemoria`
+            log_info(cpuLog, "PID: %u - Acción: LEER - Dir. Lógica: %u - Tamaño: %u - Valor: %s", core->pid_actual, logical_address, size_to_read, data_read);
+            free(data_read);
             break;
         }
 
         case WRITE: {
-            //! Prueba de escritorio
             log_info(cpuLog, "Ejecutando: WRITE. Parámetros: %s, %s", decodedInstruction->params[0], decodedInstruction->params[1]);
             // Obtenemos los parámetros de la instrucción decodificada.
-            uint32_t logical_address = atoi(decodedInstruction->params[0]);
+            uint32_t logical_address = decodedInstruction->args[0];
             char* data_to_write = decodedInstruction->params[1];
             uint32_t data_size = strlen(data_to_write) + 1; // +1 para el terminador '\0'
-            uint32_t physical_address;
-
-            // Traducimos la dirección lógica a física usando la MMU.
-            tMmuStatus status = translate_address(pid_actual, logical_address, &physical_address);
 
-            if (status == MMU_SEG_FAULT) {
-                log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar escribir en la dirección lógica %u", pid_actual, logical_address);
-                // TODO: Enviar paquete a Kernel con motivo de SEG_FAULT.
+            uint64_t accessStart = 0;
+            uint64_t translatedNs = 0;
+            trace_begin_access(accessStart, translatedNs);
+            tMmuStatus status = mmu_write(logical_address, data_size, data_to_write);
+            trace_end_access(accessStart, translatedNs);
+            if (status != MMU_OK) {
+                log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar escribir en la dirección lógica %u", core->pid_actual, logical_address);
+                segmentationFault();
                 break;
             }
 
-            // Logueamos la acción antes de enviar el paquete.
-            log_info(cpuLog, "PID: %u - Acción: ESCRIBIR - Dir. Lógica: %u -> Dir. Física: %u - Valor: %s", 
-                    pid_actual, logical_address, physical_address, data_to_write);
-
-            //  Creamos el paquete y lo enviamos a Memoria con los 4 parámetros.
-            tPackage* req = createPackage(CPU_TO_MEMORIA_WRITE);
-            addToPackage(req, &pid_actual, sizeof(uint32_t));
-            addToPackage(req, &physical_address, sizeof(uint32_t)); // La dirección física
-            addToPackage(req, &data_size, sizeof(uint32_t));      // El tamaño de los datos
-            addToPackage(req, data_to_write, data_size);          // Los datos en sí
-            
-            sendPackage(req, connectionSocketMemory);
-            
-            // La CPU ahora debe esperar el MEMORIA_TO_CPU_WRITE_ACK en su hilo de servidor
-            // para continuar con la siguiente instrucción.
+            log_info(cpuLog, "PID: %u - Acción: ESCRIBIR - Dir. Lógica: %u - Valor: %s", core->pid_actual, logical_address, data_to_write);
             break;
         }
         case GOTO:
+            log_info(cpuLog, "PID: %u - Ejecutando: GOTO %ld", core->pid_actual, (long)decodedInstruction->args[0]);
+            core->pc_actual = decodedInstruction->args[0];
             break;
-        case IO_INST:
+        case IO_INST: {
+            log_info(cpuLog, "PID: %u - Syscall: IO %s %s", core->pid_actual, decodedInstruction->params[0], decodedInstruction->params[1]);
+            tPackage* package_to_kernel = createPackage(CPU_DISPATCH_TO_KERNEL_IO);
+            addToPackage(package_to_kernel, decodedInstruction->params[0], strlen(decodedInstruction->params[0]) + 1);
+            int usage_time = decodedInstruction->args[1];
+            addToPackage(package_to_kernel, &usage_time, sizeof(int));
+            returnContextToKernel(package_to_kernel);
             break;
-        case INIT_PROC:
+        }
+        case INIT_PROC: {
+            log_info(cpuLog, "PID: %u - Syscall: INIT_PROC %s %s", core->pid_actual, decodedInstruction->params[0], decodedInstruction->params[1]);
+            tPackage* package_to_kernel = createPackage(CPU_DISPATCH_TO_KERNEL_INIT_PROC);
+            addToPackage(package_to_kernel, decodedInstruction->params[0], strlen(decodedInstruction->params[0]) + 1);
+            int process_size = decodedInstruction->args[1];
+            addToPackage(package_to_kernel, &process_size, sizeof(int));
+            returnContextToKernel(package_to_kernel);
             break;
+        }
         case DUMP_MEMORY:
+            log_info(cpuLog, "PID: %u - Syscall: DUMP_MEMORY", core->pid_actual);
+            // El dump lee la memoria del proceso, así que antes tiene que tener las escrituras que están solo en la caché:
+            page_cache_flush_process(core->pid_actual);
+            returnContextToKernel(createPackage(CPU_DISPATCH_TO_KERNEL_DUMP_MEMORY));
             break;
         case EXIT_INST:
         {
-            log_info(cpuLog, "PID: %d - Syscall: EXIT. Notificando al Kernel.", pid_actual);
+            mmu_invalidate_process(core->pid_actual);
+            instruction_cache_invalidate_process(core->pid_actual);
+            log_info(cpuLog, "PID: %d - Syscall: EXIT. Notificando al Kernel.", core->pid_actual);
             tPackage* package_to_kernel = createPackage(CPU_DISPATCH_TO_KERNEL_EXIT);
-            sendPackage(package_to_kernel, connectionSocketDispatchKernel);
+            sendPackage(package_to_kernel, core->connectionSocketDispatchKernel);
             // Detenemos el ciclo de instrucción localmente
-            ciclo_de_instruccion_activo = false;
+            core->ciclo_de_instruccion_activo = false;
             break;
         }
 
         default:
             break;
     }
-
-    free(decodedInstruction);
 }
\ No newline at end of file
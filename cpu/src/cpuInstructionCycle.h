@@ -3,9 +3,13 @@
 
 #include "utils.h"
 
+// Lo que tarda un NOOP (se suma como retardo simulado, ver runInstructionCycle)
+#define NOOP_DELAY_NS 2000000000ull
+
 void fetch(int, int);
 void requestFreeMemoryMock();
-tDecodedInstruction* decode(char*);
+bool decode(const char*, tDecodedInstruction*);
 void execute(tDecodedInstruction*);
+long runInstructionCycle(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "cpu.h"
+#include "cpuInterrupt.h"
+
+// Flujo de una interrupción del Kernel (desalojo por SRT): el hilo de interrupt del núcleo recibe KERNEL_TO_CPU_INTERRUPT_INTERRUPTION
+// y llama a interrupt_request; el ciclo de instrucción la ve al terminar la instrucción en curso, devuelve el contexto (el PC)
+// con CPU_DISPATCH_TO_KERNEL_PREEMPTION_COMPLETED y deja la CPU. Lo que tarda entre una cosa y la otra va al histograma ackLatency.
+
+// Hilo de interrupt: marca la interrupción para el núcleo, con el pid del proceso que el Kernel quiere desalojar. Siempre queda pendiente,
+// aunque el núcleo no esté ejecutando: puede haber llegado antes que el dispatch de ese proceso. Al empezar la ráfaga se compara el pid:
+void interrupt_request(uint32_t pid) {
+    atomic_store_explicit(&core->interrupts.pid, pid, memory_order_relaxed);
+    atomic_store_explicit(&core->interrupts.receivedNs, nanoseconds(), memory_order_relaxed);
+    atomic_store_explicit(&core->interrupts.pending, true, memory_order_release);
+    log_info(cpuLog, "CPU %d: interrupción recibida para el PID %u, se desaloja al terminar la instrucción en curso.", core->cpuId, pid);
+}
+
+// Si la interrupción pendiente es de otro proceso (uno que ya dejó la CPU), no se desaloja al que empieza y se descarta.
+// Si es del que empieza, queda pendiente y se atiende al terminar su primera instrucción:
+void interrupt_begin_burst(void) {
+    if (interrupt_pending() && atomic_load_explicit(&core->interrupts.pid, memory_order_relaxed) != core->pid_actual) {
+        atomic_store_explicit(&core->interrupts.pending, false, memory_order_relaxed);
+        core->interrupts.ignored++;
+        log_info(cpuLog, "CPU %d: interrupción pendiente para el PID %u descartada, arranca el PID %u.", core->cpuId,
+                 atomic_load_explicit(&core->interrupts.pid, memory_order_relaxed), core->pid_actual);
+    }
+}
+
+// El proceso ya dejó la CPU: si la interrupción pendiente era para él no queda nada que desalojar (una para otro pid se conserva):
+void interrupt_end_burst(void) {
+    if (interrupt_pending() && atomic_load_explicit(&core->interrupts.pid, memory_order_relaxed) == core->pid_actual)
+        atomic_store_explicit(&core->interrupts.pending, false, memory_order_relaxed);
+}
+
+// Ciclo de instrucción: devuelve el contexto al Kernel y registra cuánto tardó desde que llegó la interrupción:
+void interrupt_acknowledge(void) {
+    tPackage* package = createPackage(CPU_DISPATCH_TO_KERNEL_PREEMPTION_COMPLETED);
+    addToPackage(package, &core->pc_actual, sizeof(uint32_t));
+    sendPackage(package, core->connectionSocketDispatchKernel);
+
+    uint64_t latency = nanoseconds() - atomic_load_explicit(&core->interrupts.receivedNs, memory_order_relaxed);
+    histogram_record(&core->interrupts.ackLatency, latency);
+    atomic_store_explicit(&core->interrupts.pending, false, memory_order_relaxed);
+    log_info(cpuLog, "PID: %u - Desalojado por interrupción - PC: %u - Latencia interrupción-ack: %.3f ms", core->pid_actual, core->pc_actual, latency / 1e6);
+}
+
+void interrupt_report(void) {
+    tLatencyHistogram* histogram = &core->interrupts.ackLatency;
+    if (histogram->count == 0 && core->interrupts.ignored == 0) return;
+
+    log_info(cpuLog, "CPU %d: %lu interrupciones atendidas (%lu descartadas por ser de otro proceso). Latencia interrupción-ack: "
+             "media %.3f ms, p50 <= %.3f ms, p90 <= %.3f ms, p99 <= %.3f ms, máx %.3f ms",
+             core->cpuId, (unsigned long)histogram->count, (unsigned long)core->interrupts.ignored,
+             histogram_mean(histogram) / 1e6,
+             histogram_percentile(histogram, 50) / 1e6, histogram_percentile(histogram, 90) / 1e6,
+             histogram_percentile(histogram, 99) / 1e6, histogram->maxNs / 1e6);
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+        if (histogram->buckets[i])
+            log_debug(cpuLog, "CPU %d: latencia <= %lu ns: %lu", core->cpuId, (unsigned long)histogram_bucket_upper(i), (unsigned long)histogram->buckets[i]);
+}
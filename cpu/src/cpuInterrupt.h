@@ -0,0 +1,28 @@
+#ifndef CPU_INTERRUPT_H
+#define CPU_INTERRUPT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <histogram.h>
+
+// Estado de interrupciones de un núcleo. El hilo de interrupt prende pending y anota para qué proceso es (pid) y cuándo llegó;
+// el ciclo de instrucción lo mira entre instrucción e instrucción:
+typedef struct {
+    atomic_bool pending;
+    _Atomic uint32_t pid;
+    _Atomic uint64_t receivedNs;
+    uint64_t ignored;
+    tLatencyHistogram ackLatency;
+} tInterruptState;
+
+void interrupt_request(uint32_t pid);
+void interrupt_begin_burst(void);
+void interrupt_end_burst(void);
+void interrupt_acknowledge(void);
+void interrupt_report(void);
+
+// Se consulta en cada instrucción, así que es una sola lectura atómica:
+#define interrupt_pending() atomic_load_explicit(&core->interrupts.pending, memory_order_acquire)
+
+#endif
@@ -1,19 +1,17 @@
 #include "cpu.h"
 #include "cpuServer.h"
+#include "mmu.h"
 
 
 int finishServer;
 
-// Es la función del hilo de CPU Dispatch de recepción de información desde Kernel.
+// Es la función de CPU Dispatch de recepción de información desde Kernel, corre en el hilo del núcleo (ver cpuCore.c).
 // Dependiendo del código de operación del paquete, decide qué hacer.
 // Es bloqueante en receivePackage:
-void *serverDispatchThreadForKernel(void *voidPointerConnectionSocket)
+void *serverDispatchThreadForKernel(void *voidPointerCore)
 {
-    int connectionSocket = *((int *)voidPointerConnectionSocket);
-    free(voidPointerConnectionSocket);
-
-
-    connectionSocketDispatchKernel = connectionSocket;
+    core = voidPointerCore;
+    int connectionSocket = core->connectionSocketDispatchKernel;
     tPackage *package = NULL;
     t_list *list = NULL;
 
@@ -39,27 +37,15 @@ void *serverDispatchThreadForKernel(void *voidPointerConnectionSocket)
         {
             case KERNEL_TO_CPU_DISPATCH_TEST: {
                 // Se recibe el contexto inicial del Kernel
-                list = packageToList(package);
-                pid_actual = extractIntElementFromList(list, 0);
-                pc_actual = extractIntElementFromList(list, 1);
-                list_destroy_and_destroy_elements(list, free);
-                list = NULL;
+                core->pid_actual = extractIntElementFromList(list, 0);
+                core->pc_actual = extractIntElementFromList(list, 1);
 
-                log_info(cpuLog, "Recibido contexto - PID: %d - PC inicial: %d. Iniciando ciclo de instrucción.", pid_actual, pc_actual);
+                log_info(cpuLog, "Recibido contexto - PID: %d - PC inicial: %d. Iniciando ciclo de instrucción.", core->pid_actual, core->pc_actual);
                 
-                ciclo_de_instruccion_activo = true;
+                // Fetch, decode y execute corren en este mismo hilo hasta que el proceso deja la CPU (EXIT, syscall, SEGMENTATION FAULT o desalojo):
+                runInstructionCycle();
                 
-                // --- INICIA EL BUCLE DEL CICLO DE INSTRUCCIÓN ---
-                while(ciclo_de_instruccion_activo) {
-                    // 1. Fetch: Pedimos la instrucción a Memoria
-                    fetch(pid_actual, pc_actual);
-
-                    // 2. Esperar: El hilo se bloquea aquí hasta que el hilo de memoria 
-                    //    termine de ejecutar la instrucción y haga sem_post()
-                    sem_wait(&sem_ciclo_instruccion); 
-                }
-                
-                log_info(cpuLog, "PID: %d - Ciclo de instrucción finalizado. Esperando nuevo contexto.", pid_actual);
+                log_info(cpuLog, "PID: %d - Ciclo de instrucción finalizado. Esperando nuevo contexto.", core->pid_actual);
                 break;
             }
         
@@ -88,13 +74,13 @@ void *serverDispatchThreadForKernel(void *voidPointerConnectionSocket)
     return NULL;
 }
 
-// Es la función del hilo de CPU Interrupt de recepción de información desde Kernel.
+// Es la función del hilo de CPU Interrupt de recepción de información desde Kernel, uno por núcleo.
 // Dependiendo del código de operación del paquete, decide qué hacer.
 // Es bloqueante en receivePackage:
-void *serverInterruptThreadForKernel(void *voidPointerConnectionSocket)
+void *serverInterruptThreadForKernel(void *voidPointerCore)
 {
-    int connectionSocket = *((int *)voidPointerConnectionSocket);
-    free(voidPointerConnectionSocket);
+    core = voidPointerCore;
+    int connectionSocket = core->connectionSocketInterruptKernel;
 
     tPackage *package = NULL;
     t_list *list = NULL;
@@ -119,6 +105,10 @@ void *serverInterruptThreadForKernel(void *voidPointerConnectionSocket)
 
         switch (package->operationCode)
         {
+        case KERNEL_TO_CPU_INTERRUPT_INTERRUPTION:
+            // Solo se marca: el ciclo de instrucción del núcleo la atiende al terminar la instrucción en curso si es del proceso que ejecuta
+            interrupt_request(extractIntElementFromList(list, 0));
+            break;
         case DO_NOTHING:
             log_info(cpuLog, "RECIBIDO MENSAJE VACIO DESDE KERNEL.");
             break;
@@ -144,90 +134,68 @@ void *serverInterruptThreadForKernel(void *voidPointerConnectionSocket)
     return NULL;
 }
 
-// Es la función del hilo de CPU Dispatch de recepción de información desde Memoria.
-// Dependiendo del código de operación del paquete, decide qué hacer.
-// Es bloqueante en receivePackage:
+// Es la función del hilo de la conexión con Memoria, compartida por todos los núcleos.
+// Memoria nunca manda nada sin que se lo pidan: con un solo núcleo, el ciclo de instrucción recibe cada respuesta en su propio hilo
+// y este hilo no tiene nada que escuchar. Con varios, recibe todas las respuestas y le entrega cada una al núcleo que la pidió
+// (ver memory_deliver_response). Es bloqueante en receivePackage:
 void *serverThreadForMemoria(void *voidPointerConnectionSocket)
 {
     int connectionSocket = *((int *)voidPointerConnectionSocket);
     free(voidPointerConnectionSocket);
 
-    tPackage *package = NULL;
-    t_list *list = NULL;
+    if (!memory_is_multiplexed()) {
+        log_info(cpuLog, "Conexión de CPU con Memoria lista (socket %d), la usa el ciclo de instrucción del núcleo.", connectionSocket);
+        return NULL;
+    }
 
-    log_info(cpuLog, "Hilo de servidor de CPU para escuchar mensajes de Memoria creado exitosamente.");
-    while (!finishServer)
-    {
+    log_info(cpuLog, "Conexión de CPU con Memoria lista (socket %d), compartida por %d núcleos.", connectionSocket, coreCount);
+    tPackage *package;
+    do {
         package = receivePackage(connectionSocket);
+        memory_deliver_response(package);
+    } while (package && !finishServer);
 
-        if (!package || finishServer)
-        {
-            if (package)
-            {
-                destroyPackage(package);
-                package = NULL;
-            }
-            close(connectionSocket);
-            break;
-        }
+    return NULL;
+}
 
-        list = packageToList(package);
+// Es la función del hilo de la conexión de interrupt con Memoria, una para todo el proceso. Memoria la usa solo para los shootdowns
+// (ver memoriaShootdown.c): se aplica la invalidación en cada núcleo, esperando a que termine la instrucción que esté ejecutando,
+// y recién después se confirma. Es bloqueante en receivePackage:
+void *serverShootdownThreadForMemoria(void *voidPointerConnectionSocket)
+{
+    int connectionSocket = *((int *)voidPointerConnectionSocket);
+    free(voidPointerConnectionSocket);
 
-        switch (package->operationCode)
+    log_info(cpuLog, "Hilo de shootdown de Memoria creado exitosamente (socket %d).", connectionSocket);
+    tPackage *package;
+    while (!finishServer && (package = receivePackage(connectionSocket)) != NULL)
+    {
+        if (package->operationCode == MEMORIA_TO_CPU_SHOOTDOWN)
         {
+            t_list *list = packageToList(package);
+            uint32_t id = extractIntElementFromList(list, 0);
+            uint32_t pid = extractIntElementFromList(list, 1);
+            uint32_t first = extractIntElementFromList(list, 2);
+            uint32_t count = extractIntElementFromList(list, 3);
+            list_destroy_and_destroy_elements(list, free);
 
-
-            case MEMORIA_TO_CPU_SEND_INSTRUCTION: {
-                // Obtenemos el puntero a la instrucción, NO lo liberamos aquí.
-                char* instruction_string = extractStringElementFromList(list, 0);
-                log_info(cpuLog, "Instrucción recibida desde Memoria: %s", instruction_string);
-
-                tDecodedInstruction* decoded = decode(instruction_string);
-
-                // Verificamos si es EXIT para terminar el ciclo
-                if (decoded->operation == EXIT_INST) {
-                    log_info(cpuLog, "PID: %d - Instrucción EXIT recibida. Finalizando ejecución.", pid_actual);
-                    ciclo_de_instruccion_activo = false;
-                    // Aquí deberías enviar el contexto de vuelta al Kernel con motivo EXIT
-                    execute(decoded); // execute se encarga de liberar la estructura 'decoded'
-                } else {
-                    execute(decoded); // execute se encarga de liberar la estructura 'decoded'
-                    // Actualizamos el PC si la instrucción no fue GOTO
-                    if (decoded->operation != GOTO) {
-                        pc_actual++;
-                    }
-                }
-                
-                // Le avisamos al hilo de dispatch que el ciclo puede continuar
-                sem_post(&sem_ciclo_instruccion);
-                break; // Salimos del switch
+            // Las funciones de la MMU trabajan sobre el núcleo de la variable core, así que este hilo la va apuntando a cada uno
+            for (int i = 0; i < coreCount; i++)
+            {
+                pthread_mutex_lock(&cores[i].mmuMutex);
+                core = &cores[i];
+                mmu_shootdown(pid, first, count);
+                pthread_mutex_unlock(&cores[i].mmuMutex);
             }
+            core = NULL;
 
-
-
-        case DO_NOTHING:
-            log_info(cpuLog, "RECIBIDO MENSAJE VACIO DESDE KERNEL.");
-            break;
-        case ERROR:
-        default:
-            break;
+            tPackage *ack = createPackage(CPU_TO_MEMORIA_SHOOTDOWN_ACK);
+            addToPackage(ack, &id, sizeof(uint32_t));
+            sendPackage(ack, connectionSocket);
         }
-
         destroyPackage(package);
-        package = NULL;
-
-        if (list)
-        {
-            list_destroy_and_destroy_elements(list, free);
-            list = NULL;
-        }
     }
 
-    if (package)
-        destroyPackage(package);
-    if (list)
-        list_destroy_and_destroy_elements(list, free);
+    close(connectionSocket);
     return NULL;
-
-
-}
\ No newline at end of file
+}
@@ -1,9 +1,10 @@
 #ifndef CPU_SERVER_H
 #define CPU_SERVER_H
 
-void* serverDispatchThreadForKernel(void* voidPointerConnectionSocket);
-void* serverInterruptThreadForKernel(void* voidPointerConnectionSocket);
+void* serverDispatchThreadForKernel(void* voidPointerCore);
+void* serverInterruptThreadForKernel(void* voidPointerCore);
 void* serverThreadForMemoria(void* voidPointerConnectionSocket);
+void* serverShootdownThreadForMemoria(void* voidPointerConnectionSocket);
 
 extern int connectionSocketMemory;
 extern int finishServer;
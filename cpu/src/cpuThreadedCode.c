@@ -0,0 +1,152 @@
+#include "cpu.h"
+#include "cpuThreadedCode.h"
+
+// Camino rápido para las rachas de NOOP / GOTO, que no necesitan ni a Memoria ni al Kernel: a partir de las instrucciones ya decodificadas
+// de la caché de instrucciones se arma un bloque de código enhebrado (cada paso guarda la dirección de su código y el índice del siguiente,
+// con los GOTO ya resueltos) y se ejecuta con goto computado, sin fetch, decode ni logs por instrucción. Los retardos (el de NOOP y, si
+// la caché así lo pide, el del fetch) no se duermen uno por uno: se suman en core->pendingDelayNs y el ciclo los espera juntos.
+// Se sale al ciclo normal en la primera instrucción que no es NOOP / GOTO (o que no está en la caché), al juntar el retardo
+// de una instrucción (ver delaySliceNs), o si llegó una interrupción.
+
+// Retardo acumulado a partir del cual se vuelve al ciclo normal para esperarlo: el de la instrucción más lenta que se enhebra (un NOOP
+// con su fetch). Así nunca se junta más de una instrucción de retardo, y una interrupción espera lo mismo que en el ciclo normal.
+// Se calcula en cada racha porque retardoMemoria llega con el handshake de Memoria:
+static inline uint64_t delaySliceNs(void) {
+    return NOOP_DELAY_NS + (core->instruction_cache.keepFetchDelay ? (uint64_t)retardoMemoria * 1000000ull : 0);
+}
+
+void threaded_code_init(int blocks) {
+    memset(&core->threaded, 0, sizeof(tThreadedCode));
+    if (blocks <= 0 || !core->instruction_cache.entries) {
+        log_info(cpuLog, "Código enhebrado deshabilitado%s.", blocks > 0 ? " (necesita la caché de instrucciones)" : "");
+        return;
+    }
+
+    core->threaded.blocks = calloc(blocks, sizeof(tThreadedBlock));
+    core->threaded.count = blocks;
+    log_info(cpuLog, "Código enhebrado habilitado con %d bloques de hasta %d instrucciones.", blocks, THREADED_BLOCK_SLOTS);
+}
+
+static inline tThreadedBlock* threaded_block_slot(uint32_t pid, uint32_t pc) {
+    uint32_t hash = (pc * 2654435761u) ^ (pid * 0x9E3779B9u);
+    return &core->threaded.blocks[(hash ^ (hash >> 16)) % core->threaded.count];
+}
+
+static int findSlot(tThreadedBlock* block, uint32_t pc) {
+    for (int i = 0; i < block->count; i++)
+        if (block->slots[i].pc == pc)
+            return i;
+    return -1;
+}
+
+// Traduce el bloque que empieza en (pid, startPc): recorre la cadena de instrucciones siguiendo los GOTO hasta cerrar un ciclo
+// (el siguiente PC ya tiene su paso) o hasta una instrucción que no se puede enhebrar, que queda como paso de salida.
+// handlers trae las direcciones de código de threaded_run: [0] NOOP, [1] GOTO, [2] salida:
+static void translateBlock(tThreadedBlock* block, uint32_t pid, uint32_t startPc, const void* const* handlers) {
+    uint64_t fetchDelayNs = core->instruction_cache.keepFetchDelay ? (uint64_t)retardoMemoria * 1000000ull : 0;
+
+    block->pid = pid;
+    block->startPc = startPc;
+    block->generation = core->instruction_cache.invalidations;
+    block->valid = true;
+    block->count = 0;
+    core->threaded.translations++;
+
+    uint32_t pc = startPc;
+    while (true) {
+        tThreadedSlot* slot = &block->slots[block->count++];
+        slot->pc = pc;
+        slot->next = 0;
+        slot->uncached = false;
+        slot->delayNs = 0;
+
+        tDecodedInstruction* decoded = instruction_cache_peek(pid, pc);
+        bool pure = decoded && (decoded->operation == NOOP || decoded->operation == GOTO);
+        // El último lugar queda siempre para una salida
+        if (!pure || block->count == THREADED_BLOCK_SLOTS) {
+            slot->handler = handlers[2];
+            slot->uncached = !decoded;
+            return;
+        }
+
+        if (decoded->operation == NOOP) {
+            slot->handler = handlers[0];
+            slot->delayNs = NOOP_DELAY_NS + fetchDelayNs;
+            pc = pc + 1;
+        } else {
+            slot->handler = handlers[1];
+            slot->delayNs = fetchDelayNs;
+            pc = decoded->args[0];
+        }
+
+        int existing = findSlot(block, pc);
+        if (existing >= 0) {
+            slot->next = existing;
+            return;
+        }
+        slot->next = block->count;
+    }
+}
+
+// Ejecuta desde (pid_actual, pc_actual) todas las instrucciones NOOP / GOTO que se puedan seguidas, y deja pc_actual en la primera
+// que hay que ejecutar por el ciclo normal. Retorna cuántas instrucciones ejecutó (0 si la del PC actual no se puede enhebrar):
+long threaded_run(void) {
+    static const void* const handlers[] = { &&op_noop, &&op_goto, &&op_exit };
+
+    // Hasta que la ráfaga no hizo su primer fetch real, la caché de instrucciones puede tener una imagen vieja
+    if (!core->threaded.blocks || !core->instruction_cache.imageChecked)
+        return 0;
+
+    uint32_t pid = core->pid_actual;
+    tThreadedBlock* block = threaded_block_slot(pid, core->pc_actual);
+    if (!block->valid || block->pid != pid || block->startPc != core->pc_actual || block->generation != core->instruction_cache.invalidations)
+        translateBlock(block, pid, core->pc_actual, handlers);
+
+    long executed = 0;
+    uint64_t slice = delaySliceNs();
+    const tThreadedSlot* slot = &block->slots[0];
+
+// Cada paso se despacha al siguiente por su cuenta (sin volver a un switch central), y antes mira si hay que volver al ciclo normal:
+#define DISPATCH_NEXT()                                                                              \
+    do {                                                                                             \
+        executed++;                                                                                  \
+        core->pendingDelayNs += slot->delayNs;                                                       \
+        slot = &block->slots[slot->next];                                                            \
+        if (core->pendingDelayNs >= slice || interrupt_pending())                                    \
+            goto out;                                                                                \
+        goto *slot->handler;                                                                         \
+    } while (0)
+
+    goto *slot->handler;
+
+op_noop:
+    DISPATCH_NEXT();
+
+op_goto:
+    DISPATCH_NEXT();
+
+op_exit:
+    // Si se salió porque la instrucción todavía no estaba en la caché, la próxima vez se traduce de nuevo (para entonces ya va a estar)
+    if (slot->uncached)
+        block->valid = false;
+
+out:
+#undef DISPATCH_NEXT
+    core->pc_actual = slot->pc;
+    if (executed > 0) {
+        core->threaded.runs++;
+        core->threaded.instructions += executed;
+        core->instruction_cache.hits += executed;
+        log_debug(cpuLog, "PID: %u - Código enhebrado: %ld instrucciones seguidas, sigue en PC %u", pid, executed, core->pc_actual);
+    }
+    return executed;
+}
+
+void threaded_code_destroy(void) {
+    if (!core->threaded.blocks) return;
+
+    log_info(cpuLog, "Código enhebrado: %lu traducciones, %lu instrucciones en %lu rachas.", (unsigned long)core->threaded.translations,
+             (unsigned long)core->threaded.instructions, (unsigned long)core->threaded.runs);
+    free(core->threaded.blocks);
+    memset(&core->threaded, 0, sizeof(tThreadedCode));
+}
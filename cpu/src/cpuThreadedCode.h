@@ -0,0 +1,44 @@
+#ifndef CPU_THREADED_CODE_H
+#define CPU_THREADED_CODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Instrucciones por bloque traducido (contando la de salida)
+#define THREADED_BLOCK_SLOTS 64
+
+// Un paso del código enhebrado: la dirección del código que lo ejecuta (etiqueta de threaded_run), el PC de la instrucción,
+// el retardo simulado que suma y el índice del paso siguiente. Un paso de salida devuelve el control al ciclo normal en su PC:
+typedef struct {
+    const void* handler;
+    uint32_t pc;
+    uint16_t next;
+    bool uncached; // salida porque la instrucción todavía no estaba en la caché de instrucciones
+    uint64_t delayNs;
+} tThreadedSlot;
+
+// Bloque traducido a partir de (pid, startPc): la cadena de NOOP / GOTO que sigue desde ahí, siguiendo los saltos, hasta la primera
+// instrucción que necesita a Memoria o al Kernel. generation es el contador de invalidaciones de la caché de instrucciones al traducirlo:
+typedef struct {
+    uint32_t pid;
+    uint32_t startPc;
+    uint64_t generation;
+    bool valid;
+    int count;
+    tThreadedSlot slots[THREADED_BLOCK_SLOTS];
+} tThreadedBlock;
+
+// Bloques traducidos de un núcleo, de mapeo directo por (pid, pc) (blocks es NULL si está deshabilitado):
+typedef struct {
+    tThreadedBlock* blocks;
+    int count;
+    uint64_t translations;
+    uint64_t runs;
+    uint64_t instructions;
+} tThreadedCode;
+
+void threaded_code_init(int blocks);
+long threaded_run(void);
+void threaded_code_destroy(void);
+
+#endif
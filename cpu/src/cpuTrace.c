@@ -0,0 +1,229 @@
+#include "cpu.h"
+#include "cpuTrace.h"
+#include <stdio.h>
+
+// Traza binaria por instrucción (ver cpuTrace.h). El núcleo escribe en su anillo y mueve head; el hilo de volcado copia al archivo
+// lo que hay entre tail y head y mueve tail. Cada índice lo escribe un solo hilo, así que alcanza con store-release / load-acquire.
+
+#define TRACE_RING_MASK (TRACE_RING_RECORDS - 1)
+#define TRACE_DRAIN_PERIOD_US 10000
+
+bool traceEnabled = false;
+
+static FILE* traceFile;
+static pthread_t traceDrainThread;
+static atomic_bool traceDraining;
+
+uint64_t trace_now(void) {
+    return nanoseconds();
+}
+
+// Lo llama el núcleo al terminar la instrucción: pasa el registro en curso al anillo (o lo descarta si el hilo de volcado viene atrasado)
+// y lo deja en cero para la próxima:
+void trace_commit(uint32_t pid, uint32_t pc, uint8_t opcode, uint32_t instructions) {
+    tTraceRing* ring = &core->trace;
+    tTraceRecord* record = &ring->current;
+    record->timestampNs = trace_now();
+    record->pid = pid;
+    record->pc = pc;
+    record->opcode = opcode;
+    record->instructions = instructions;
+    record->cpuId = core->cpuId;
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= TRACE_RING_RECORDS) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    } else {
+        ring->records[head & TRACE_RING_MASK] = *record;
+        atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    }
+    memset(record, 0, sizeof(tTraceRecord));
+}
+
+// Vuelca al archivo lo que haya en el anillo de cada núcleo (a lo sumo dos tramos contiguos por anillo). Retorna cuántos registros escribió:
+static uint64_t trace_drain(void) {
+    uint64_t written = 0;
+    for (int i = 0; i < coreCount; i++) {
+        tTraceRing* ring = &cores[i].trace;
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail < head) {
+            uint64_t index = tail & TRACE_RING_MASK;
+            uint64_t chunk = head - tail < TRACE_RING_RECORDS - index ? head - tail : TRACE_RING_RECORDS - index;
+            fwrite(&ring->records[index], sizeof(tTraceRecord), chunk, traceFile);
+            tail += chunk;
+            written += chunk;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return written;
+}
+
+static void* traceDrainThreadFunction(void* unused) {
+    (void)unused;
+    while (atomic_load_explicit(&traceDraining, memory_order_acquire)) {
+        if (trace_drain() == 0)
+            usleep(TRACE_DRAIN_PERIOD_US);
+    }
+    return NULL;
+}
+
+// Abre el archivo, le reserva el anillo a cada núcleo y levanta el hilo de volcado. Va después de cores_create y antes de cores_start,
+// porque traceEnabled no puede cambiar con los núcleos andando. Retorna false (y la traza queda apagada) si no se pudo:
+bool trace_start(const char* path) {
+    traceFile = fopen(path, "wb");
+    if (!traceFile) {
+        log_error(cpuLog, "No se pudo abrir el archivo de traza %s.", path);
+        return false;
+    }
+
+    tTraceFileHeader header = { TRACE_MAGIC, TRACE_VERSION, sizeof(tTraceRecord) };
+    fwrite(&header, sizeof(header), 1, traceFile);
+
+    for (int i = 0; i < coreCount; i++) {
+        cores[i].trace.records = malloc(TRACE_RING_RECORDS * sizeof(tTraceRecord));
+        if (!cores[i].trace.records) {
+            log_error(cpuLog, "No se pudo reservar el anillo de traza del núcleo %d.", i);
+            for (int j = 0; j < i; j++) {
+                free(cores[j].trace.records);
+                cores[j].trace.records = NULL;
+            }
+            fclose(traceFile);
+            traceFile = NULL;
+            return false;
+        }
+    }
+
+    atomic_store(&traceDraining, true);
+    pthread_create(&traceDrainThread, NULL, traceDrainThreadFunction, NULL);
+    traceEnabled = true;
+    log_info(cpuLog, "Traza binaria por instrucción en %s (%d registros de %zu bytes por núcleo).", path, TRACE_RING_RECORDS, sizeof(tTraceRecord));
+    return true;
+}
+
+// Frena el hilo de volcado y baja lo que quedó. Los anillos no se liberan: los núcleos pueden seguir ejecutando hasta que termina el proceso:
+void trace_stop(void) {
+    if (!traceEnabled || !traceFile) return;
+
+    atomic_store(&traceDraining, false);
+    pthread_join(traceDrainThread, NULL);
+    trace_drain();
+    fclose(traceFile);
+    traceFile = NULL;
+
+    for (int i = 0; i < coreCount; i++) {
+        uint64_t dropped = atomic_load(&cores[i].trace.dropped);
+        if (dropped)
+            log_warning(cpuLog, "CPU %d: %lu registros de traza descartados con el anillo lleno.", cores[i].cpuId, (unsigned long)dropped);
+    }
+}
+
+// Resumen de un archivo de traza, sin conectarse a nadie. Uso: ./bin/cpu --trace-summary <archivo>
+
+static const char* traceOpcodeName(uint8_t opcode) {
+    static const char* names[] = {
+        [NOOP] = "NOOP", [WRITE] = "WRITE", [READ] = "READ", [GOTO] = "GOTO", [IO_INST] = "IO",
+        [INIT_PROC] = "INIT_PROC", [DUMP_MEMORY] = "DUMP_MEMORY", [EXIT_INST] = "EXIT", [UNKNOWN] = "DESCONOCIDA",
+    };
+    if (opcode == TRACE_OPCODE_THREADED) return "ENHEBRADO";
+    return opcode <= UNKNOWN ? names[opcode] : "?";
+}
+
+typedef struct {
+    uint64_t records;
+    uint64_t instructions;
+    tLatencyHistogram fetch;
+    tLatencyHistogram translate;
+    tLatencyHistogram memory;
+} tTraceOpcodeSummary;
+
+static void logTraceHistogram(const char* label, const char* what, tLatencyHistogram* histogram) {
+    if (histogram->count == 0) return;
+    log_info(cpuLog, "  %-11s %-9s media %9.1f us, p50 <= %9.1f us, p99 <= %9.1f us, máx %9.1f us", label, what,
+             histogram_mean(histogram) / 1e3, histogram_percentile(histogram, 50) / 1e3,
+             histogram_percentile(histogram, 99) / 1e3, histogram->maxNs / 1e3);
+}
+
+static double ratio(uint64_t part, uint64_t total) {
+    return total ? 100.0 * part / total : 0.0;
+}
+
+// Retorna 0 si pudo leer el archivo completo, 1 si no existe, no es una traza o está cortado:
+int runTraceSummary(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        log_error(cpuLog, "No se pudo abrir el archivo de traza %s.", path);
+        return 1;
+    }
+
+    tTraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION
+        || header.recordSize != sizeof(tTraceRecord)) {
+        log_error(cpuLog, "%s no es una traza de CPU válida (o es de otra versión).", path);
+        fclose(file);
+        return 1;
+    }
+
+    // Un resumen por opcode, más el de las rachas de código enhebrado en la última posición:
+    tTraceOpcodeSummary* byOpcode = calloc(UNKNOWN + 2, sizeof(tTraceOpcodeSummary));
+    uint64_t records = 0, instructions = 0, firstNs = UINT64_MAX, lastNs = 0;
+    uint64_t tlbHits = 0, tlbMisses = 0, cacheHits = 0, cacheMisses = 0, icacheHits = 0, fetched = 0;
+    int maxCpuId = -1;
+
+    tTraceRecord buffer[1024];
+    size_t count;
+    while ((count = fread(buffer, sizeof(tTraceRecord), 1024, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            tTraceRecord* record = &buffer[i];
+            tTraceOpcodeSummary* summary = &byOpcode[record->opcode == TRACE_OPCODE_THREADED || record->opcode > UNKNOWN ? UNKNOWN + 1 : record->opcode];
+            summary->records++;
+            summary->instructions += record->instructions;
+            records++;
+            instructions += record->instructions;
+            if (record->timestampNs < firstNs) firstNs = record->timestampNs;
+            if (record->timestampNs > lastNs) lastNs = record->timestampNs;
+            if (record->cpuId > maxCpuId) maxCpuId = record->cpuId;
+
+            if (record->opcode != TRACE_OPCODE_THREADED) {
+                histogram_record(&summary->fetch, record->fetchNs);
+                fetched++;
+                if (record->flags & TRACE_ICACHE_HIT) icacheHits++;
+            }
+            if (record->flags & (TRACE_TLB_HIT | TRACE_TLB_MISS))
+                histogram_record(&summary->translate, record->translateNs);
+            if (record->flags & (TRACE_CACHE_HIT | TRACE_CACHE_MISS) || record->memoryNs)
+                histogram_record(&summary->memory, record->memoryNs);
+            tlbHits += (record->flags & TRACE_TLB_HIT) != 0;
+            tlbMisses += (record->flags & TRACE_TLB_MISS) != 0;
+            cacheHits += (record->flags & TRACE_CACHE_HIT) != 0;
+            cacheMisses += (record->flags & TRACE_CACHE_MISS) != 0;
+        }
+    }
+    bool truncated = ferror(file) || (ftell(file) - (long)sizeof(header)) % sizeof(tTraceRecord) != 0;
+    fclose(file);
+
+    double seconds = records ? (lastNs - firstNs) / 1e9 : 0.0;
+    log_info(cpuLog, "Traza %s: %lu registros, %lu instrucciones en %.3f s (%.0f instrucciones por segundo), CPU id máximo %d",
+             path, (unsigned long)records, (unsigned long)instructions, seconds, seconds > 0 ? instructions / seconds : 0.0, maxCpuId);
+    log_info(cpuLog, "Caché de instrucciones: %.1f%% de hits; TLB: %.1f%% de hits (%lu hits, %lu misses); Caché de Páginas: %.1f%% de hits (%lu hits, %lu misses)",
+             ratio(icacheHits, fetched), ratio(tlbHits, tlbHits + tlbMisses), (unsigned long)tlbHits, (unsigned long)tlbMisses,
+             ratio(cacheHits, cacheHits + cacheMisses), (unsigned long)cacheHits, (unsigned long)cacheMisses);
+
+    for (int opcode = 0; opcode <= UNKNOWN + 1; opcode++) {
+        tTraceOpcodeSummary* summary = &byOpcode[opcode];
+        if (summary->records == 0) continue;
+        const char* name = traceOpcodeName(opcode == UNKNOWN + 1 ? TRACE_OPCODE_THREADED : opcode);
+        log_info(cpuLog, "%s: %lu registros, %lu instrucciones (%.1f%%)", name, (unsigned long)summary->records,
+                 (unsigned long)summary->instructions, ratio(summary->instructions, instructions));
+        logTraceHistogram(name, "fetch", &summary->fetch);
+        logTraceHistogram(name, "traducir", &summary->translate);
+        logTraceHistogram(name, "memoria", &summary->memory);
+    }
+    free(byOpcode);
+
+    if (truncated) {
+        log_error(cpuLog, "La traza %s está cortada: el último registro está incompleto.", path);
+        return 1;
+    }
+    return 0;
+}
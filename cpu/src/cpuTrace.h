@@ -0,0 +1,76 @@
+#ifndef CPU_TRACE_H
+#define CPU_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Traza binaria por instrucción: cada núcleo arma un registro de tamaño fijo por instrucción (o por racha de código enhebrado) y lo deja
+// en su anillo sin locks (un productor, el núcleo; un consumidor, el hilo que vuelca al archivo TRAZA_ARCHIVO). Si el anillo está lleno
+// el registro se descarta y se cuenta. Con la traza apagada cada punto de medición cuesta un solo salto (traceEnabled no cambia nunca).
+
+#define TRACE_MAGIC 0x41525443u // "CTRA" en little endian
+#define TRACE_VERSION 2
+#define TRACE_RING_RECORDS 16384 // potencia de 2
+
+// Bits de flags de un registro
+#define TRACE_TLB_HIT      0x01
+#define TRACE_TLB_MISS     0x02
+#define TRACE_CACHE_HIT    0x04 // Caché de Páginas
+#define TRACE_CACHE_MISS   0x08
+#define TRACE_ICACHE_HIT   0x10 // la instrucción salió de la caché de instrucciones
+
+// opcode de un registro que resume una racha de código enhebrado (instructions instrucciones desde pc)
+#define TRACE_OPCODE_THREADED 0xFF
+
+typedef struct {
+    uint64_t timestampNs; // nanoseconds() al terminar la instrucción
+    uint32_t pid;
+    uint32_t pc;
+    // Los tiempos van en 64 bits: una instrucción puede tardar más de los ~4,29 s que entran en 32 (por ejemplo, un fetch con retardo)
+    uint64_t fetchNs;     // fetch + decode
+    uint64_t translateNs; // traducciones de la MMU (TLB y tablas de páginas)
+    uint64_t memoryNs;    // accesos a datos (Caché de Páginas y Memoria), sin contar las traducciones
+    uint32_t instructions;
+    uint16_t cpuId;
+    uint8_t opcode;       // tInstructionType
+    uint8_t flags;
+} tTraceRecord;
+
+_Static_assert(sizeof(tTraceRecord) == 48, "el registro de traza tiene que ocupar 48 bytes");
+
+// Encabezado del archivo, seguido de los registros de todos los núcleos (ordenados por núcleo dentro de cada volcado, no globalmente):
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+} tTraceFileHeader;
+
+typedef struct {
+    tTraceRecord* records; // NULL si la traza está apagada
+    _Atomic uint64_t head; // próximo a escribir (solo lo mueve el núcleo)
+    _Atomic uint64_t tail; // próximo a volcar (solo lo mueve el hilo de volcado)
+    _Atomic uint64_t dropped;
+    tTraceRecord current;  // registro de la instrucción en curso
+} tTraceRing;
+
+extern bool traceEnabled;
+
+#define trace_on() __builtin_expect(traceEnabled, 0)
+
+bool trace_start(const char* path);
+void trace_stop(void);
+uint64_t trace_now(void);
+void trace_commit(uint32_t pid, uint32_t pc, uint8_t opcode, uint32_t instructions);
+int runTraceSummary(const char* path);
+
+// Puntos de medición: cada uno es un if sobre traceEnabled, así que apagados no hacen nada más.
+#define trace_flag(flag) do { if (trace_on()) core->trace.current.flags |= (flag); } while (0)
+#define trace_begin(start) do { if (trace_on()) (start) = trace_now(); } while (0)
+#define trace_end(field, start) do { if (trace_on()) core->trace.current.field += trace_now() - (start); } while (0)
+// Un acceso a datos de la MMU cuenta como memoria todo lo que tardó menos lo que se fue en traducir (que ya sumó translateNs):
+#define trace_begin_access(start, translated) do { if (trace_on()) { (start) = trace_now(); (translated) = core->trace.current.translateNs; } } while (0)
+#define trace_end_access(start, translated) \
+    do { if (trace_on()) core->trace.current.memoryNs += (trace_now() - (start)) - (core->trace.current.translateNs - (translated)); } while (0)
+
+#endif
@@ -1,23 +1,53 @@
 #include "cpu.h"
 #include "mmu.h" 
-uint32_t pid_actual = 0;
+#include "cpuBench.h"
 int cpuId;
 uint32_t tamanioPagina;
 uint32_t entradasPorTabla;
 uint32_t cantidadNiveles;
-uint32_t last_read_size = 0;
-uint32_t pc_actual;
-bool ciclo_de_instruccion_activo;
-sem_t sem_ciclo_instruccion;
+uint32_t retardoMemoria;
 
 
-int connectionSocketDispatchKernel; // Definición de la variable global para el llamado desde el execute
 int connectionSocketMemory; 
 
 
 int main(int argc, char* argv[]){
 
-    // Valida y asigna el número de CPU
+    // Modo benchmark del decodificador, sin conectarse a nadie. Uso: ./bin/cpu --bench-decode <iteraciones>
+    if (argc == 3 && strcmp(argv[1], "--bench-decode") == 0) {
+        // El decodificador solo loguea errores, así que por este logger solo sale el resultado del benchmark
+        cpuLog = log_create("CPU_BENCH.log", "CPU_BENCH", true, LOG_LEVEL_INFO);
+        int result = runDecodeBenchmark(atol(argv[2]));
+        log_destroy(cpuLog);
+        return result;
+    }
+
+    // Benchmark del ciclo de instrucción contra una Memoria falsa (antes y después de pasarlo a un solo hilo). Uso: ./bin/cpu --bench-cycle <instrucciones>
+    if (argc == 3 && strcmp(argv[1], "--bench-cycle") == 0) {
+        // Solo errores en el logger de la CPU: si no, los logs de cada instrucción taparían el resultado
+        cpuLog = log_create("CPU_BENCH.log", "CPU", false, LOG_LEVEL_ERROR);
+        int result = runCycleBenchmark(atol(argv[2]));
+        log_destroy(cpuLog);
+        return result;
+    }
+
+    // Benchmark del código enhebrado contra el ciclo normal, con un programa de GOTO sin fin. Uso: ./bin/cpu --bench-threaded <milisegundos>
+    if (argc == 3 && strcmp(argv[1], "--bench-threaded") == 0) {
+        cpuLog = log_create("CPU_BENCH.log", "CPU", false, LOG_LEVEL_ERROR);
+        int result = runThreadedBenchmark(atol(argv[2]));
+        log_destroy(cpuLog);
+        return result;
+    }
+
+    // Resumen de una traza binaria grabada con TRAZA_ARCHIVO, sin conectarse a nadie. Uso: ./bin/cpu --trace-summary <archivo>
+    if (argc == 3 && strcmp(argv[1], "--trace-summary") == 0) {
+        cpuLog = log_create("CPU_TRACE.log", "CPU_TRACE", true, LOG_LEVEL_INFO);
+        int result = runTraceSummary(argv[2]);
+        log_destroy(cpuLog);
+        return result;
+    }
+
+    // Valida y asigna el número de CPU (el del primer núcleo)
     if (argc < 2){
         cpuLogCreate();
         log_info(cpuLog, "Ingrese el número de CPU:");
@@ -30,19 +60,52 @@ int main(int argc, char* argv[]){
 
     cpuConfigInitialize();
 
-    // Hilos para solicitar conexiones con Kernel: uno para Distpatch y otro para Interrupt
-    createThreadForRequestingConnection(cpuLog, getCpuConfig()->IP_KERNEL, getCpuConfig()->PUERTO_KERNEL_DISPATCH, &handshakeFromDispatchToKernel, &serverDispatchThreadForKernel);
-    createThreadForRequestingConnection(cpuLog, getCpuConfig()->IP_KERNEL, getCpuConfig()->PUERTO_KERNEL_INTERRUPT, &handshakeFromInterruptToKernel, &serverInterruptThreadForKernel);
+    // Cantidad de núcleos: el segundo argumento, o si no NUCLEOS del config. Uso: ./bin/cpu <id de CPU> [núcleos]
+    int cores = argc >= 3 ? atoi(argv[2]) : getCpuConfig()->NUCLEOS;
+    if (cores < 1) {
+        log_error(cpuLog, "Cantidad de núcleos inválida: %d.", cores);
+        logDestroy(cpuLog);
+        configDestroy(cpuConfigFile, cpuConfig);
+        return 1;
+    }
+
+    // Una sola conexión con Memoria para todos los núcleos. Va primero y en este hilo, porque la MMU de cada núcleo necesita el tamaño de página:
+    int connectionSocket = createConnectionSocket(getCpuConfig()->IP_MEMORIA, getCpuConfig()->PUERTO_MEMORIA);
+    if (connectionSocket == -1 || !handshakeFromDispatchToMemoria(connectionSocket)) {
+        log_error(cpuLog, "No se pudo establecer la conexión con Memoria.");
+        logDestroy(cpuLog);
+        configDestroy(cpuConfigFile, cpuConfig);
+        return 1;
+    }
+    memory_multiplex_init(cores);
+    createThreadForConnectingToModule(connectionSocket, &serverThreadForMemoria);
+
+    // Cada núcleo, en su hilo, se conecta con el Kernel (Dispatch e Interrupt) con su propio cpuId
+    cores_create(cores, cpuId);
+
+    // Segunda conexión con Memoria, la de interrupt, por donde llegan los shootdowns de TLB. Va después de armar los núcleos, porque los recorre:
+    int shootdownSocket = createConnectionSocket(getCpuConfig()->IP_MEMORIA, getCpuConfig()->PUERTO_MEMORIA);
+    if (shootdownSocket == -1 || !handshakeFromInterruptToMemoria(shootdownSocket)) {
+        log_error(cpuLog, "No se pudo establecer la conexión de interrupt con Memoria.");
+        logDestroy(cpuLog);
+        configDestroy(cpuConfigFile, cpuConfig);
+        return 1;
+    }
+    createThreadForConnectingToModule(shootdownSocket, &serverShootdownThreadForMemoria);
 
-    // Hilo para solicitar conexión con Memoria: solo para Distpatch
-    createThreadForRequestingConnection(cpuLog, getCpuConfig()->IP_MEMORIA, getCpuConfig()->PUERTO_MEMORIA, &handshakeFromDispatchToMemoria, &serverThreadForMemoria);
+    // El prefetch (por salto o por lookahead) trae las páginas desde su propio hilo, con su propia conexión con Memoria
+    if (getCpuConfig()->PREFETCH_PAGINAS > 0 || getCpuConfig()->LOOKAHEAD_INSTRUCCIONES > 0)
+        prefetch_start();
 
-    // Inicializamos el semáforo en 0 para que el hilo que haga wait() se bloquee
-    sem_init(&sem_ciclo_instruccion, 0, 0); 
-    mmu_init();
+    // La traza se prende antes de arrancar los núcleos y ya no cambia (ver cpuTrace.h)
+    if (getCpuConfig()->TRAZA_ARCHIVO && *getCpuConfig()->TRAZA_ARCHIVO)
+        trace_start(getCpuConfig()->TRAZA_ARCHIVO);
+    cores_start();
+    log_info(cpuLog, "CPU levantada con %d núcleos (CPU %d a %d).", cores, cpuId, cpuId + cores - 1);
 
     // Se pide que se ingrese un caracter para que no termine abruptamente, y se destruyen el logger y config:
     getchar();
+    trace_stop();
     logDestroy(cpuLog);
     configDestroy(cpuConfigFile, cpuConfig);
     return 0;
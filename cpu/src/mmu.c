@@ -1,226 +1,432 @@
 #include "mmu.h"
 #include "cpu.h"
+#include "mmuPrefetch.h"
 #include <math.h> // Para usar floor en el cálculo de la cantidad de tablas
 
-t_queue* tlb;
-t_list* tlb_as_list;
-t_list* page_cache;
-
-
-
 // Inicializa la MMU, seteando la TLB y la Caché de Páginas en el caso de que el archivo config así lo indique.
 void mmu_init() {
     // Inicializar TLB si está habilitada
+    memset(&core->tlb, 0, sizeof(tTlbCache));
     if (cpuConfig->ENTRADAS_TLB > 0) {
-        tlb = queue_create();
-        tlb_as_list = tlb->elements;
-        log_info(cpuLog, "MMU: TLB habilitada con %d entradas y algoritmo %s.", cpuConfig->ENTRADAS_TLB, cpuConfig->REEMPLAZO_TLB);
+        tlb_init(cpuConfig->ENTRADAS_TLB, cpuConfig->ASOCIATIVIDAD_TLB, strcmp(cpuConfig->REEMPLAZO_TLB, "LRU") == 0);
+        core->tlb.quota = cpuConfig->CUOTA_TLB < core->tlb.ways ? cpuConfig->CUOTA_TLB : 0;
+        log_info(cpuLog, "MMU: TLB habilitada con %d entradas (%d conjuntos de %d vías) y algoritmo %s.", core->tlb.sets * core->tlb.ways, core->tlb.sets, core->tlb.ways, cpuConfig->REEMPLAZO_TLB);
     } else {
-        tlb = NULL;
-        tlb_as_list = NULL;
         log_info(cpuLog, "MMU: TLB deshabilitada.");
     }
     
+    // Inicializar la caché de tablas intermedias (solo tiene sentido con más de un nivel)
+    memset(&core->walk_cache, 0, sizeof(tWalkCache));
+    if (cpuConfig->ENTRADAS_CACHE_TABLAS > 0 && cantidadNiveles > 1) {
+        walk_cache_init(cpuConfig->ENTRADAS_CACHE_TABLAS, cantidadNiveles);
+        log_info(cpuLog, "MMU: Caché de tablas intermedias habilitada con %d entradas por nivel.", cpuConfig->ENTRADAS_CACHE_TABLAS);
+    }
+
     // Inicializar Caché de Páginas si está habilitada
+    memset(&core->page_cache, 0, sizeof(tPageCacheState));
     if (cpuConfig->ENTRADAS_CACHE > 0) {
-        page_cache = list_create();
-        log_info(cpuLog, "MMU: Caché de Páginas habilitada con %d entradas y algoritmo %s.", cpuConfig->ENTRADAS_CACHE, cpuConfig->REEMPLAZO_CACHE);
+        page_cache_init(cpuConfig->ENTRADAS_CACHE, strcmp(cpuConfig->REEMPLAZO_CACHE, "CLOCK-M") == 0 ? CACHE_CLOCK_M : CACHE_CLOCK);
+        core->page_cache.writeBack = strcmp(cpuConfig->ESCRITURA_CACHE, "WRITE_BACK") == 0;
+        core->page_cache.quota = cpuConfig->CUOTA_CACHE < core->page_cache.entries ? cpuConfig->CUOTA_CACHE : 0;
+        log_info(cpuLog, "MMU: Caché de Páginas habilitada con %d entradas, algoritmo %s y escritura %s.", cpuConfig->ENTRADAS_CACHE, cpuConfig->REEMPLAZO_CACHE, cpuConfig->ESCRITURA_CACHE);
     } else {
-        page_cache = NULL;
         log_info(cpuLog, "MMU: Caché de Páginas deshabilitada.");
     }
+
+    prefetch_init(cpuConfig->PREFETCH_PAGINAS, cpuConfig->LOOKAHEAD_INSTRUCCIONES, strcmp(cpuConfig->PREFETCH_MODO, "PAGINAS") == 0);
+    if (core->prefetcher.distance > 0)
+        log_info(cpuLog, "MMU: Prefetch de %d páginas (%s).", core->prefetcher.distance, cpuConfig->PREFETCH_MODO);
+    if (core->prefetcher.lookahead > 0)
+        log_info(cpuLog, "MMU: Lookahead de %d instrucciones sobre la caché de instrucciones (%s).", core->prefetcher.lookahead, cpuConfig->PREFETCH_MODO);
 }
 
-tMmuStatus mmu_read(uint32_t logicalAddress, uint32_t size, void* buffer_out) {
+void tlb_flush() {
+    if (!core->tlb.entries) return;
 
-    uint32_t page_size = tamanioPagina;
-    uint32_t bytes_read = 0;
-
-    while (bytes_read < size) {
-        
-        uint32_t current_logicalAddress = logicalAddress + bytes_read;
-        uint32_t page_number = current_logicalAddress / page_size;
-        uint32_t offset = current_logicalAddress % page_size;
-        uint32_t size_to_read_in_page = page_size - offset;
-        
-        if (size_to_read_in_page > (size - bytes_read)) {
-            size_to_read_in_page = size - bytes_read;
-        }
+    for (int i = 0; i < core->tlb.sets * core->tlb.ways; i++) {
+        core->tlb.entries[i].valid = false;
+        core->tlb.entries[i].prefetched = false;
+        core->tlb.entries[i].lruRank = i % core->tlb.ways;
+    }
+    memset(core->tlb.fifoNext, 0, sizeof(uint16_t) * core->tlb.sets);
+    log_info(cpuLog, "TLB vaciada (flush).");
+}
 
-        void* page_content = NULL;
-        tPageCache* cache_hit = page_cache_lookup( 1 /* pcb_actual->pid */, page_number); // Revisar cómo obtener el PCB
+// Vacía la caché. En write-back primero se mandan a Memoria las páginas modificadas, así no se pierde ninguna escritura:
+void page_cache_flush() {
+    if (!core->page_cache.slots) return;
 
-        if (cache_hit) {
+    if (core->page_cache.writeBack) {
+        for (int i = 0; i < core->page_cache.entries; i++) {
+            if (core->page_cache.slots[i].valid && core->page_cache.slots[i].modified)
+                page_cache_flush_process(core->page_cache.slots[i].pid);
+        }
+    }
 
-            // Cache Hit: Usar el contenido de la caché
-            log_info(cpuLog, "PID: %u - Cache Hit - Página: %u",  1 /* pcb_actual->pid */, page_number);
-            page_content = cache_hit->content;
+    for (int i = 0; i < core->page_cache.entries; i++) {
+        core->page_cache.slots[i].valid = false;
+        core->page_cache.slots[i].use = false;
+        core->page_cache.slots[i].modified = false;
+        core->page_cache.slots[i].prefetched = false;
+        core->page_cache.slots[i].hashNext = -1;
+    }
+    for (uint32_t b = 0; b <= core->page_cache.bucketMask; b++)
+        core->page_cache.buckets[b] = -1;
+    core->page_cache.clockHand = 0;
+    log_info(cpuLog, "Caché de páginas vaciada (flush).");
+}
 
-        } else {
+void mmu_destroy() {
 
-            // Cache Miss: Buscar marco y traer página de memoria
-            log_info(cpuLog, "PID: %u - Cache Miss - Página: %u",  1 /* pcb_actual->pid */, page_number);
-            uint32_t frame_number;
-            
-            // 1. Traducir dirección (TLB o Memoria)
-            if (translate_address( 1 /* pcb_actual->pid */, page_number, &frame_number) != MMU_OK) {
-                return MMU_SEG_FAULT;
-            }
+    prefetch_report();
 
-            // 2. Traer página de Memoria
-            if (fetch_page_from_memory( 1 /* pcb_actual->pid */, page_number, frame_number, &page_content) != MMU_OK) {
-                 // Si fetch falla, page_content será NULL, pero debemos liberarlo si se alocó memoria.
-                 if(page_content != NULL) free(page_content);
-                 return MMU_SEG_FAULT; // Suponemos que un error aquí es fatal
-            }
-            
-            // 3. Agregar a la caché
-            page_cache_add( 1 /* pcb_actual->pid */, page_number, page_content);
-            log_info(cpuLog, "PID: %u - Cache Add - Página: %u",  1 /* pcb_actual->pid */, page_number);
-        }
+    if (core->tlb.entries) {
+        log_info(cpuLog, "TLB: %lu hits, %lu misses, %lu reemplazos.", (unsigned long)core->tlb.hits, (unsigned long)core->tlb.misses, (unsigned long)core->tlb.evictions);
+        free(core->tlb.entries);
+        free(core->tlb.fifoNext);
+        memset(&core->tlb, 0, sizeof(tTlbCache));
+    }
 
-        // Copiar el dato desde el contenido de la página (obtenido de caché o memoria) al buffer de salida
-        memcpy(buffer_out + bytes_read, page_content + offset, size_to_read_in_page);
-        
-        // Si el contenido fue traido de memoria, ya podemos liberarlo, pues ya está en la caché y en el buffer de salida.
-        if (!cache_hit) {
-            free(page_content);
+    if (core->walk_cache.entries) {
+        for (int level = 1; level < core->walk_cache.levels; level++) {
+            uint64_t lookups = core->walk_cache.hits[level - 1] + core->walk_cache.misses[level - 1];
+            log_info(cpuLog, "Caché de tablas, nivel %d: %lu hits de %lu búsquedas (%.1f%%).", level, (unsigned long)core->walk_cache.hits[level - 1],
+                     (unsigned long)lookups, lookups ? 100.0 * core->walk_cache.hits[level - 1] / lookups : 0.0);
         }
+        free(core->walk_cache.entries);
+        free(core->walk_cache.hits);
+        free(core->walk_cache.misses);
+        memset(&core->walk_cache, 0, sizeof(tWalkCache));
+    }
 
-        bytes_read += size_to_read_in_page;
+    if (core->page_cache.slots) {
+        log_info(cpuLog, "Caché de Páginas: %lu hits, %lu misses, %lu reemplazos, %lu páginas escritas en %lu mensajes.", (unsigned long)core->page_cache.hits, (unsigned long)core->page_cache.misses,
+                 (unsigned long)core->page_cache.evictions, (unsigned long)core->page_cache.writebacks, (unsigned long)core->page_cache.flushMessages);
+        free(core->page_cache.slots);
+        free(core->page_cache.contents);
+        free(core->page_cache.buckets);
+        memset(&core->page_cache, 0, sizeof(tPageCacheState));
     }
 
-    return MMU_OK;
+    log_info(cpuLog, "MMU destruida.");
 }
 
-tMmuStatus mmu_write(uint32_t logicalAddress, uint32_t size, void* buffer_in) {
-
-    uint32_t page_size = tamanioPagina;
-    uint32_t bytes_written = 0;
-    
-    while(bytes_written < size) {
-        uint32_t current_logicalAddress = logicalAddress + bytes_written;
-        //uint32_t page_number = current_logicalAddress / page_size;
-        uint32_t offset = current_logicalAddress % page_size;
-        uint32_t size_to_write_in_page = page_size - offset;
-
 
+// Arma la caché de tablas intermedias: entriesPerLevel entradas para cada nivel que apunta a otra tabla (1..levels-1):
+void walk_cache_init(int entriesPerLevel, int levels) {
+    core->walk_cache.entriesPerLevel = entriesPerLevel;
+    core->walk_cache.levels = levels;
+    core->walk_cache.entries = calloc((size_t)entriesPerLevel * (levels - 1), sizeof(tWalkCacheEntry));
+    core->walk_cache.hits = calloc(levels - 1, sizeof(uint64_t));
+    core->walk_cache.misses = calloc(levels - 1, sizeof(uint64_t));
+}
 
+// El prefijo de un nivel son los índices de la página hasta ese nivel inclusive: dos páginas con el mismo prefijo pasan por la misma tabla del nivel siguiente.
+// Con el prefijo y el pid se elige la única entrada (mapeo directo) que puede tenerlo:
+static tWalkCacheEntry* walk_cache_slot(uint32_t pid, int level, uint32_t page_number, uint32_t* prefix) {
+    *prefix = page_number / (uint32_t)pow(entradasPorTabla, cantidadNiveles - level);
+    uint32_t hash = (*prefix * 2654435761u) ^ (pid * 0x9E3779B9u);
+    return &core->walk_cache.entries[(level - 1) * core->walk_cache.entriesPerLevel + (hash ^ (hash >> 16)) % core->walk_cache.entriesPerLevel];
+}
 
-        if(size_to_write_in_page > (size - bytes_written)) {
-            size_to_write_in_page = size - bytes_written;
-        }
-
-        // 1. Declaramos la variable para la dirección física.
-        uint32_t physical_address;
-        
-        // 2. Llamamos a translate_address con la firma correcta:
-        //    Le pasamos la dirección LÓGICA completa y esperamos la FÍSICA de vuelta.
-        if (translate_address(pid_actual, current_logicalAddress, &physical_address) != MMU_OK) {
-            log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar escribir en la dirección lógica %u", pid_actual, current_logicalAddress);
-            // TODO: Enviar paquete a Kernel con motivo de SEG_FAULT.
-            return MMU_SEG_FAULT;
-        }
-
-        // Enviar la escritura a memoria (Write-Through)
-        if (memory_write(physical_address, size_to_write_in_page, buffer_in + bytes_written) != 0) { // Definir luego la función en cpuClient.c
-            log_error(cpuLog, "PID: %u - Error al escribir en memoria física en la dirección %u",  1 /* pcb_actual->pid */, physical_address);
-            return MMU_SEG_FAULT; // Asumimos que un error de escritura es un fallo grave
-        }
-        
-        // Invalidar la entrada en la caché de páginas, ya que su contenido ahora es obsoleto.
-        uint32_t page_number = current_logicalAddress / page_size;
-        page_cache_invalidate( 1 /* pcb_actual->pid */, page_number);
-        
-        log_info(cpuLog, "PID: %u - Escritura en Memoria - Dir. Lógica: %u -> Dir. Física: %u, Tamaño: %u",
-                 1 /* pcb_actual->pid */, current_logicalAddress, physical_address, size_to_write_in_page);
-
-        bytes_written += size_to_write_in_page;
+static bool walk_cache_lookup(uint32_t pid, int level, uint32_t page_number, uint64_t* table) {
+    uint32_t prefix;
+    tWalkCacheEntry* entry = walk_cache_slot(pid, level, page_number, &prefix);
+    if (entry->valid && entry->prefix == prefix && entry->pid == pid) {
+        core->walk_cache.hits[level - 1]++;
+        *table = entry->table;
+        log_info(cpuLog, "PID: %u - Caché de tablas HIT - Página: %u, Nivel: %d", pid, page_number, level);
+        return true;
     }
-
-    return MMU_OK;
+    core->walk_cache.misses[level - 1]++;
+    return false;
 }
 
-void tlb_flush() {
-    if (!tlb) return;
-    
-    void invalidate_entry(void* element) {
-        ((tTlb*) element)->valid = false;
-    }
+static void walk_cache_add(uint32_t pid, int level, uint32_t page_number, uint64_t table) {
+    if (!core->walk_cache.entries) return;
 
-    list_iterate(tlb_as_list, invalidate_entry);
-    log_info(cpuLog, "TLB vaciada (flush).");
+    uint32_t prefix;
+    tWalkCacheEntry* entry = walk_cache_slot(pid, level, page_number, &prefix);
+    entry->pid = pid;
+    entry->prefix = prefix;
+    entry->table = table;
+    entry->valid = true;
 }
 
-void page_cache_flush() {
-    if (!page_cache) return;
+// Las tablas de un proceso dejan de existir cuando Memoria lo elimina, así que sus entradas no pueden quedar en la caché:
+void walk_cache_invalidate_process(uint32_t pid) {
+    if (!core->walk_cache.entries) return;
 
-    void cache_entry_destroyer(void* element) {
-        tPageCache* entry = (tPageCache*) element;
-        free(entry->content);
-        free(entry);
+    for (int i = 0; i < core->walk_cache.entriesPerLevel * (core->walk_cache.levels - 1); i++) {
+        if (core->walk_cache.entries[i].pid == pid)
+            core->walk_cache.entries[i].valid = false;
     }
-
-    list_clean_and_destroy_elements(page_cache, cache_entry_destroyer);
-    log_info(cpuLog, "Caché de páginas vaciada (flush).");
 }
 
-void mmu_destroy() {
-
-    if (tlb) {
-        queue_destroy_and_destroy_elements(tlb, free);
+// Plan de un acceso de la MMU. Un READ / WRITE se parte en tramos, uno por página, y de cada tramo se sabe de antemano qué hace falta:
+// la traducción (si no está en la TLB, una entrada de tabla por nivel, desde el más profundo que conozca la caché de tablas) y los datos
+// (la página entera si hay Caché de Páginas, o si no el pedazo del tramo). Los pedidos que no dependen uno de otro salen juntos en un solo
+// CPU_TO_MEMORIA_BATCH por vuelta: en cada vuelta, el próximo nivel de cada tramo sin traducir y los datos de los tramos ya traducidos.
+// Así un acceso cuesta tantas idas y vueltas como niveles más uno, sin importar cuántas páginas toque.
+// Los datos de un tramo salen recién cuando todos los tramos anteriores están traducidos: si uno da SEG_FAULT, Memoria queda igual que
+// si los tramos se hubieran hecho de a uno, en orden.
+typedef struct {
+    uint32_t logical;
+    uint32_t page;
+    uint32_t offset;
+    uint32_t size;
+    char* buffer;    // parte del buffer del READ / WRITE que le toca al tramo
+    bool translated;
+    uint32_t frame;
+    int level;       // próximo nivel de la tabla a pedir
+    uint64_t table;
+    bool needsData;
+    tMemoriaBatchKind dataKind;
+    void* page_content; // página entera traída para la caché (NULL si solo se lee el tramo)
+    int item;        // pedido de la vuelta actual (-1 si no tiene)
+} tAccessPiece;
+
+// Parte [logical_address, logical_address + size) en tramos de una página. El arreglo lo libera el que llama:
+static int plan_pieces(uint32_t logical_address, uint32_t size, void* buffer, tAccessPiece** pieces) {
+    int count = size == 0 ? 0 : (int)((logical_address + size - 1) / tamanioPagina - logical_address / tamanioPagina + 1);
+    *pieces = calloc(count > 0 ? count : 1, sizeof(tAccessPiece));
+
+    uint32_t done = 0;
+    for (int i = 0; i < count; i++) {
+        tAccessPiece* piece = &(*pieces)[i];
+        piece->logical = logical_address + done;
+        piece->page = piece->logical / tamanioPagina;
+        piece->offset = piece->logical % tamanioPagina;
+        piece->size = tamanioPagina - piece->offset < size - done ? tamanioPagina - piece->offset : size - done;
+        piece->buffer = (char*)buffer + done;
+        piece->item = -1;
+        done += piece->size;
     }
+    return count;
+}
 
-    if (page_cache) {
-        page_cache_flush(); // Reutilizamos la lógica de flush para destruir elementos
-        list_destroy(page_cache);
+// Busca la traducción del tramo en la TLB; si no está, deja anotado desde qué nivel hay que recorrer la tabla:
+static void plan_translation(uint32_t pid, tAccessPiece* piece) {
+    if (tlb_lookup(pid, piece->page, &piece->frame)) {
+        piece->translated = true;
+        return;
     }
+    log_info(cpuLog, "PID: %u - TLB MISS - Página: %u", pid, piece->page);
+
+    piece->level = 1;
+    piece->table = 0; // La primera tabla (Nivel 1) no necesita dirección previa
+    // Si la caché de tablas intermedias ya conoce la tabla de algún nivel para este prefijo, se arranca desde ahí (probando del más profundo al primero):
+    for (int level = cantidadNiveles - 1; level >= 1 && core->walk_cache.entries; level--) {
+        if (walk_cache_lookup(pid, level, piece->page, &piece->table)) {
+            piece->level = level + 1;
+            break;
+        }
+    }
+}
 
-    log_info(cpuLog, "MMU destruida.");
+static void plan_data(tAccessPiece* piece, tMemoriaBatchKind kind, bool wholePage) {
+    piece->needsData = true;
+    piece->dataKind = kind;
+    if (wholePage)
+        piece->page_content = malloc(tamanioPagina);
 }
 
+// Agrega a la vuelta la entrada de tabla del tramo, o reusa la de otro tramo que pasa por la misma tabla en el mismo nivel:
+static int plan_table_item(uint32_t pid, tAccessPiece* piece, tMemoriaBatchItem* items, int count) {
+    int divisor = pow(entradasPorTabla, cantidadNiveles - piece->level);
+    int index = (piece->page / divisor) % entradasPorTabla;
+    for (int i = 0; i < count; i++) {
+        if (items[i].kind == MEMORIA_BATCH_PAGE_TABLE_ENTRY && items[i].level == piece->level && items[i].table == piece->table && items[i].index == index)
+            return i;
+    }
+    items[count] = (tMemoriaBatchItem){ .kind = MEMORIA_BATCH_PAGE_TABLE_ENTRY, .table = piece->table, .level = piece->level, .index = index };
+    return count;
+}
 
-tMmuStatus translate_address(uint32_t pid, uint32_t logical_address, uint32_t* physical_address) {
-    uint32_t page_number = floor(logical_address / tamanioPagina);
-    uint32_t offset = logical_address % tamanioPagina;
-    uint32_t frame_number;
+// Ejecuta el plan vuelta por vuelta. Retorna MMU_SEG_FAULT si alguna traducción no existe o se perdió la conexión con Memoria:
+static tMmuStatus plan_run(uint32_t pid, tAccessPiece* pieces, int count) {
+    tMemoriaBatchItem* items = malloc((count > 0 ? count : 1) * sizeof(tMemoriaBatchItem));
+    tMmuStatus status = MMU_OK;
+
+    while (status == MMU_OK) {
+        int itemCount = 0;
+        bool walking = false;
+        bool previousTranslated = true;
+        for (int i = 0; i < count; i++) {
+            tAccessPiece* piece = &pieces[i];
+            piece->item = -1;
+            if (!piece->translated) {
+                piece->item = plan_table_item(pid, piece, items, itemCount);
+                itemCount += piece->item == itemCount;
+                walking = true;
+            } else if (piece->needsData && previousTranslated) {
+                bool whole = piece->page_content != NULL;
+                items[itemCount] = (tMemoriaBatchItem){
+                    .kind = piece->dataKind,
+                    .address = piece->frame * tamanioPagina + (whole ? 0 : piece->offset),
+                    .size = whole ? tamanioPagina : piece->size,
+                    .data = whole ? piece->page_content : piece->buffer,
+                };
+                piece->item = itemCount++;
+            }
+            previousTranslated = previousTranslated && piece->translated;
+        }
+        if (itemCount == 0)
+            break;
+
+        uint64_t start = 0;
+        trace_begin(start);
+        if (memory_batch(pid, items, itemCount) != 0)
+            status = MMU_SEG_FAULT;
+        if (walking)
+            trace_end(translateNs, start);
+
+        for (int i = 0; i < count && status == MMU_OK; i++) {
+            tAccessPiece* piece = &pieces[i];
+            if (piece->item < 0)
+                continue;
+            if (piece->translated) {
+                piece->needsData = false;
+                continue;
+            }
 
-    if (tlb_lookup(pid, page_number, &frame_number)) {
-        *physical_address = frame_number * tamanioPagina + offset;
-        return MMU_OK;
+            uint64_t entry = items[piece->item].entry;
+            if (entry == (uint64_t)-1) {
+                log_error(cpuLog, "PID: %u - SEG_FAULT - Página: %u no encontrada en tabla de páginas (nivel %d).", pid, piece->page, piece->level);
+                status = MMU_SEG_FAULT;
+            } else if (piece->level == (int)cantidadNiveles) {
+                piece->frame = (uint32_t)entry;
+                piece->translated = true;
+                log_info(cpuLog, "PID: %u - Acceso a Tabla de Páginas - Página: %u -> Marco: %u", pid, piece->page, piece->frame);
+                tlb_add(pid, piece->page, piece->frame);
+            } else {
+                piece->table = entry;
+                walk_cache_add(pid, piece->level, piece->page, entry);
+                piece->level++;
+            }
+        }
     }
 
-    log_info(cpuLog, "PID: %u - TLB MISS - Página: %u", pid, page_number);
+    free(items);
+    return status;
+}
 
-    uint64_t current_table_addr = 0; // La primera tabla (Nivel 1) no necesita dirección previa
+static void plan_destroy(tAccessPiece* pieces, int count) {
+    for (int i = 0; i < count; i++)
+        free(pieces[i].page_content);
+    free(pieces);
+}
 
-    for (int level = 1; level <= cantidadNiveles; level++) {
-        int divisor = pow(entradasPorTabla, cantidadNiveles - level);
-        int entry_index = (int)floor(page_number / divisor) % entradasPorTabla;
+tMmuStatus mmu_read(uint32_t logicalAddress, uint32_t size, void* buffer_out) {
+    uint32_t pid = core->pid_actual;
+    tAccessPiece* pieces;
+    int count = plan_pieces(logicalAddress, size, buffer_out, &pieces);
+
+    // Los tramos que están en la caché se copian ya (el acceso a la caché también tiene su retardo); el resto se traduce y se lee de Memoria,
+    // la página entera si hay caché o si no solo el pedazo que se pidió:
+    for (int i = 0; i < count; i++) {
+        tAccessPiece* piece = &pieces[i];
+        tPageCache* cache_hit = page_cache_lookup(pid, piece->page, false);
+        if (cache_hit) {
+            log_info(cpuLog, "PID: %u - Cache Hit - Página: %u", pid, piece->page);
+            simulatedSleepMs(cpuConfig->RETARDO_CACHE);
+            memcpy(piece->buffer, (char*)cache_hit->content + piece->offset, piece->size);
+            piece->translated = true;
+            continue;
+        }
+        plan_translation(pid, piece);
+        if (core->page_cache.slots)
+            log_info(cpuLog, "PID: %u - Cache Miss - Página: %u", pid, piece->page);
+        plan_data(piece, MEMORIA_BATCH_READ, core->page_cache.slots != NULL);
+    }
 
-        uint64_t entry_content = memory_get_page_table_entry(pid, current_table_addr, level, entry_index);
+    tMmuStatus status = plan_run(pid, pieces, count);
 
-        if (entry_content == (uint64_t)-1) { // Comparamos con el código de error correcto
-            log_error(cpuLog, "PID: %u - SEG_FAULT - Página: %u no encontrada en tabla de páginas (nivel %d).", pid, page_number, level);
-            return MMU_SEG_FAULT;
+    for (int i = 0; i < count && status == MMU_OK; i++) {
+        tAccessPiece* piece = &pieces[i];
+        if (piece->page_content) {
+            page_cache_add(pid, piece->page, piece->frame, piece->page_content);
+            log_info(cpuLog, "PID: %u - Cache Add - Página: %u", pid, piece->page);
+            memcpy(piece->buffer, (char*)piece->page_content + piece->offset, piece->size);
         }
+        prefetch_on_access(pid, piece->page);
+    }
 
-        if (level == cantidadNiveles) {
-            frame_number = (uint32_t)entry_content;
+    plan_destroy(pieces, count);
+    return status;
+}
+
+tMmuStatus mmu_write(uint32_t logicalAddress, uint32_t size, void* buffer_in) {
+    uint32_t pid = core->pid_actual;
+    prefetch_note_write();
+    bool writeBack = core->page_cache.slots && core->page_cache.writeBack;
+    tAccessPiece* pieces;
+    int count = plan_pieces(logicalAddress, size, buffer_in, &pieces);
+
+    // Write-back: la escritura queda en la copia de la caché (con el bit de modificado prendido), sin ir a Memoria.
+    // Si la página no está, se trae completa y se agrega antes de escribirla. Write-through: cada tramo se escribe en Memoria:
+    for (int i = 0; i < count; i++) {
+        tAccessPiece* piece = &pieces[i];
+        if (writeBack) {
+            tPageCache* cached = page_cache_lookup(pid, piece->page, true);
+            if (cached) {
+                log_info(cpuLog, "PID: %u - Cache Hit - Página: %u", pid, piece->page);
+                simulatedSleepMs(cpuConfig->RETARDO_CACHE);
+                memcpy((char*)cached->content + piece->offset, piece->buffer, piece->size);
+                log_info(cpuLog, "PID: %u - Escritura en Caché - Dir. Lógica: %u - Página: %u, Tamaño: %u", pid, piece->logical, piece->page, piece->size);
+                piece->translated = true;
+                continue;
+            }
+            log_info(cpuLog, "PID: %u - Cache Miss - Página: %u", pid, piece->page);
+            plan_translation(pid, piece);
+            plan_data(piece, MEMORIA_BATCH_READ, true);
         } else {
-            current_table_addr = entry_content;
+            plan_translation(pid, piece);
+            plan_data(piece, MEMORIA_BATCH_WRITE, false);
         }
     }
 
-    log_info(cpuLog, "PID: %u - Acceso a Tabla de Páginas - Página: %u -> Marco: %u", pid, page_number, frame_number);
-    
-    tlb_add(pid, page_number, frame_number);
-    
-    *physical_address = frame_number * tamanioPagina + offset;
+    tMmuStatus status = plan_run(pid, pieces, count);
+    if (status != MMU_OK)
+        log_error(cpuLog, "PID: %u - SEGMENTATION FAULT al intentar escribir en la dirección lógica %u", pid, logicalAddress);
+
+    for (int i = 0; i < count && status == MMU_OK; i++) {
+        tAccessPiece* piece = &pieces[i];
+        if (piece->page_content) {
+            tPageCache* cached = page_cache_add(pid, piece->page, piece->frame, piece->page_content);
+            cached->modified = true;
+            memcpy((char*)cached->content + piece->offset, piece->buffer, piece->size);
+            log_info(cpuLog, "PID: %u - Escritura en Caché - Dir. Lógica: %u - Página: %u, Tamaño: %u", pid, piece->logical, piece->page, piece->size);
+        } else if (!writeBack) {
+            // Si la página está en la caché, se actualiza su copia para que no quede obsoleta (en write-through nunca queda modificada):
+            tPageCache* cached = page_cache_lookup(pid, piece->page, false);
+            if (cached) {
+                simulatedSleepMs(cpuConfig->RETARDO_CACHE);
+                memcpy((char*)cached->content + piece->offset, piece->buffer, piece->size);
+            }
+            log_info(cpuLog, "PID: %u - Escritura en Memoria - Dir. Lógica: %u -> Dir. Física: %u, Tamaño: %u",
+                     pid, piece->logical, piece->frame * tamanioPagina + piece->offset, piece->size);
+        }
+        prefetch_on_access(pid, piece->page);
+    }
 
-    return MMU_OK;
+    plan_destroy(pieces, count);
+    return status;
 }
 
+// Traducción suelta de una dirección (sin datos): es un plan de un solo tramo. Cuenta para translateNs de la traza:
+tMmuStatus translate_address(uint32_t pid, uint32_t logical_address, uint32_t* physical_address) {
+    tAccessPiece piece = { .logical = logical_address, .page = logical_address / tamanioPagina, .offset = logical_address % tamanioPagina, .item = -1 };
+    uint64_t start = 0;
+    trace_begin(start);
+    plan_translation(pid, &piece);
+    trace_end(translateNs, start);
+
+    tMmuStatus status = plan_run(pid, &piece, 1);
+    if (status == MMU_OK)
+        *physical_address = piece.frame * tamanioPagina + piece.offset;
+    return status;
+}
 
 /*
 tMmuStatus translate_address(uint32_t pid, uint32_t logical_address, uint32_t* physical_address) {
@@ -308,113 +514,571 @@ tMmuStatus fetch_page_from_memory(uint32_t pid, uint32_t page_number, uint32_t f
     return MMU_OK;
 }
 
-bool tlb_lookup(uint32_t pid, uint32_t page, uint32_t* frame) {
-    if (!tlb || list_is_empty(tlb_as_list)) return false;
-
-    bool find_condition(void* element) {
-        tTlb* entry = (tTlb*) element;
-        return entry->pid == pid && entry->page == page && entry->valid;
+// Arma la TLB con entries entradas agrupadas en conjuntos de ways vías (si ways es 0 se usan hasta TLB_DEFAULT_WAYS vías).
+// Si entries no es múltiplo de ways, se usa el divisor de entries más cercano a ways (ante un empate, el mayor), así se
+// usan todas las entradas configuradas. Es la única reserva de memoria de la TLB:
+void tlb_init(int entries, int ways, bool lru) {
+    int configuredWays = ways;
+    if (ways <= 0)
+        ways = entries < TLB_DEFAULT_WAYS ? entries : TLB_DEFAULT_WAYS;
+    if (ways > entries)
+        ways = entries;
+    if (entries > 0 && entries % ways != 0) {
+        int below = ways, above = ways;
+        while (entries % below != 0)
+            below--;
+        while (entries % above != 0)
+            above++;
+        ways = (above - ways <= ways - below) ? above : below;
+        if (configuredWays > 0)
+            log_warning(cpuLog, "TLB: %d entradas no se pueden repartir en conjuntos de %d vías, se usan %d vías", entries, configuredWays, ways);
     }
 
-    tTlb* hit = list_find(tlb_as_list, find_condition);
+    core->tlb.ways = ways;
+    core->tlb.sets = entries / ways;
+    core->tlb.lru = lru;
+    core->tlb.hits = core->tlb.misses = core->tlb.evictions = core->tlb.prefetchesUsed = 0;
+    core->tlb.entries = calloc(core->tlb.sets * core->tlb.ways, sizeof(tTlb));
+    core->tlb.fifoNext = calloc(core->tlb.sets, sizeof(uint16_t));
+
+    // Los rangos de LRU de cada conjunto arrancan como una permutación 0..ways-1, y se mantienen así en cada acceso:
+    for (int i = 0; i < core->tlb.sets * core->tlb.ways; i++)
+        core->tlb.entries[i].lruRank = i % core->tlb.ways;
+}
 
-    if (hit) {
-        *frame = hit->frame;
-        log_info(cpuLog, "PID: %u - TLB HIT - Página: %u -> Marco: %u", pid, page, *frame);
-        
-        if (strcmp(cpuConfig->REEMPLAZO_TLB, "LRU") == 0) {
+static inline tTlb* tlb_set_of(uint32_t pid, uint32_t page) {
+    uint32_t hash = (page * 2654435761u) ^ (pid * 0x9E3779B9u);
+    return &core->tlb.entries[(hash % core->tlb.sets) * core->tlb.ways];
+}
 
-            // --- CORRECCIÓN ---
-            // Le pasamos directamente el puntero a la función de condición.
-            list_remove_element(tlb_as_list, hit); // Asumimos que queremos liberar la entrada vieja si la encontramos
-            list_add(tlb_as_list, hit);// Y agregamos la nueva (o la misma, si no liberamos)
-            
-            
-            // --- FIN DE CORRECCIÓN ---
+// Marca la entrada como la más recientemente usada de su conjunto: las que eran más nuevas que ella envejecen un lugar.
+static void tlb_touch(tTlb* set, tTlb* entry) {
+    uint16_t previousRank = entry->lruRank;
+    for (int way = 0; way < core->tlb.ways; way++) {
+        if (set[way].lruRank < previousRank)
+            set[way].lruRank++;
+    }
+    entry->lruRank = 0;
+}
 
-            //!Consultar Supuesta correc  necesita que le pases el puntero a la función de condición, no (void*)find_condition
-            // Re-agregamos el elemento al final para marcarlo como el más recientemente usado.
-            //list_remove_by_condition(tlb_as_list, (void*)find_condition);
-            // list_add(tlb_as_list, hit);
+bool tlb_lookup(uint32_t pid, uint32_t page, uint32_t* frame) {
+    if (!core->tlb.entries) return false;
+
+    tTlb* set = tlb_set_of(pid, page);
+    for (int way = 0; way < core->tlb.ways; way++) {
+        tTlb* entry = &set[way];
+        if (entry->valid && entry->page == page && entry->pid == pid) {
+            *frame = entry->frame;
+            core->tlb.hits++;
+            trace_flag(TRACE_TLB_HIT);
+            if (entry->prefetched) {
+                entry->prefetched = false;
+                core->tlb.prefetchesUsed++;
+            }
+            log_info(cpuLog, "PID: %u - TLB HIT - Página: %u -> Marco: %u", pid, page, *frame);
+            if (core->tlb.lru)
+                tlb_touch(set, entry);
+            return true;
         }
-        return true;
     }
-    
+
+    core->tlb.misses++;
+    trace_flag(TRACE_TLB_MISS);
     log_info(cpuLog, "PID: %u - TLB MISS - Página: %u", pid, page);
     return false;
 }
 
+// Si hay cuota y el proceso ya ocupa esa cantidad de vías del conjunto, devuelve su propia entrada más vieja (en FIFO lruRank
+// también sirve, porque solo se actualiza al agregar). Si no llegó a la cuota devuelve NULL:
+static tTlb* tlb_quota_victim(tTlb* set, uint32_t pid) {
+    if (core->tlb.quota <= 0) return NULL;
+
+    tTlb* oldest = NULL;
+    int owned = 0;
+    for (int way = 0; way < core->tlb.ways; way++) {
+        if (set[way].valid && set[way].pid == pid) {
+            owned++;
+            if (!oldest || set[way].lruRank > oldest->lruRank)
+                oldest = &set[way];
+        }
+    }
+    return owned >= core->tlb.quota ? oldest : NULL;
+}
+
+// Primero una vía libre; si el conjunto está lleno, la víctima es la más vieja (LRU) o la siguiente en orden de llegada (FIFO):
+static tTlb* tlb_victim(tTlb* set, int setIndex) {
+    tTlb* victim = NULL;
+    for (int way = 0; way < core->tlb.ways && !victim; way++) {
+        if (!set[way].valid)
+            victim = &set[way];
+    }
+    if (!victim) {
+        if (core->tlb.lru) {
+            for (int way = 0; way < core->tlb.ways && !victim; way++) {
+                if (set[way].lruRank == core->tlb.ways - 1)
+                    victim = &set[way];
+            }
+        } else {
+            victim = &set[core->tlb.fifoNext[setIndex]];
+            core->tlb.fifoNext[setIndex] = (core->tlb.fifoNext[setIndex] + 1) % core->tlb.ways;
+        }
+        core->tlb.evictions++;
+        log_info(cpuLog, "TLB Reemplazo: Sale PID: %u, Página: %u", victim->pid, victim->page);
+    } else if (!core->tlb.lru && victim == &set[core->tlb.fifoNext[setIndex]]) {
+        core->tlb.fifoNext[setIndex] = (core->tlb.fifoNext[setIndex] + 1) % core->tlb.ways;
+    }
+    return victim;
+}
+
 void tlb_add(uint32_t pid, uint32_t page, uint32_t frame) {
-    if (!tlb) return;
+    if (!core->tlb.entries) return;
 
-    tTlb* new_entry;
-    
-    if (list_size(tlb_as_list) >= cpuConfig->ENTRADAS_TLB) {
-        // TLB llena: aplicamos reemplazo (FIFO o LRU, la víctima es la primera de la lista).
-        new_entry = list_remove(tlb_as_list, 0); 
-        log_info(cpuLog, "TLB Reemplazo: Sale PID: %u, Página: %u", new_entry->pid, new_entry->page);
+    int setIndex = (tlb_set_of(pid, page) - core->tlb.entries) / core->tlb.ways;
+    tTlb* set = &core->tlb.entries[setIndex * core->tlb.ways];
+    tTlb* victim = tlb_quota_victim(set, pid);
+
+    // Un proceso que llegó a su cuota reemplaza su propia entrada más vieja, sin tocar las de los demás:
+    if (victim) {
+        core->tlb.evictions++;
+        log_info(cpuLog, "TLB Reemplazo (cuota): Sale PID: %u, Página: %u", victim->pid, victim->page);
     } else {
-        new_entry = malloc(sizeof(tTlb));
+        victim = tlb_victim(set, setIndex);
     }
 
-    new_entry->pid = pid;
-    new_entry->page = page;
-    new_entry->frame = frame;
-    new_entry->valid = true;
-    list_add(tlb_as_list, new_entry);
-    
+    victim->pid = pid;
+    victim->page = page;
+    victim->frame = frame;
+    victim->valid = true;
+    victim->prefetched = false;
+    tlb_touch(set, victim);
+
     log_info(cpuLog, "TLB Add: Entra PID: %u, Página: %u, Marco: %u", pid, page, frame);
 }
 
-tPageCache* page_cache_lookup(uint32_t pid, uint32_t page) {
-    if (!page_cache) return NULL;
+// Busca la traducción sin contarla como acceso (no cambia hits, misses ni el orden de LRU). La usa el prefetcher:
+bool tlb_probe(uint32_t pid, uint32_t page, uint32_t* frame) {
+    if (!core->tlb.entries) return false;
+
+    tTlb* set = tlb_set_of(pid, page);
+    for (int way = 0; way < core->tlb.ways; way++) {
+        if (set[way].valid && set[way].page == page && set[way].pid == pid) {
+            *frame = set[way].frame;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Si tlb_add_prefetched tendría lugar para la traducción (una vía libre o una prefetcheada sin usar). La usa el prefetcher antes de pedirla:
+bool tlb_has_room(uint32_t pid, uint32_t page) {
+    if (!core->tlb.entries) return false;
 
-    bool find_condition(void* element) {
-        tPageCache* entry = (tPageCache*) element;
-        return entry->pid == pid && entry->page == page;
+    tTlb* set = tlb_set_of(pid, page);
+    if (tlb_quota_victim(set, pid))
+        return false;
+    for (int way = 0; way < core->tlb.ways; way++) {
+        if (!set[way].valid || set[way].prefetched)
+            return true;
     }
-    return list_find(page_cache, find_condition);
+    return false;
 }
 
-void page_cache_add(uint32_t pid, uint32_t page, void* content) {
-    if (!page_cache) return;
+// Agrega una traducción traída por el prefetcher con la menor prioridad: solo ocupa una vía libre o la de otra entrada prefetcheada
+// que todavía no se usó, y queda como la más vieja del conjunto, así nunca desplaza a una entrada que se está usando.
+// Con certain (el lookahead, que ya vio el READ / WRITE que la va a usar) ocupa los mismos lugares, pero queda como la más nueva
+// para que no la desaloje otra prefetcheada antes de que llegue su acceso. Retorna false si no había lugar:
+bool tlb_add_prefetched(uint32_t pid, uint32_t page, uint32_t frame, bool certain) {
+    if (!core->tlb.entries) return false;
+
+    tTlb* set = tlb_set_of(pid, page);
+    tTlb* victim = NULL;
+
+    if (tlb_quota_victim(set, pid))
+        return false;
+    for (int way = 0; way < core->tlb.ways && !victim; way++) {
+        if (!set[way].valid)
+            victim = &set[way];
+    }
+    // Si no hay vía libre, la más vieja de las prefetcheadas sin usar: así una especulativa no desplaza a una del lookahead
+    if (!victim) {
+        for (int way = 0; way < core->tlb.ways; way++) {
+            if (set[way].prefetched && (!victim || set[way].lruRank > victim->lruRank))
+                victim = &set[way];
+        }
+    }
+    if (!victim)
+        return false;
+
+    victim->pid = pid;
+    victim->page = page;
+    victim->frame = frame;
+    victim->valid = true;
+    victim->prefetched = true;
+
+    if (certain) {
+        tlb_touch(set, victim);
+        log_info(cpuLog, "TLB Prefetch: Entra PID: %u, Página: %u, Marco: %u", pid, page, frame);
+        return true;
+    }
 
-    if (list_size(page_cache) >= cpuConfig->ENTRADAS_CACHE) {
-        // Caché llena: Reemplazo FIFO (elimina el más antiguo).
-        tPageCache* evicted = list_remove(page_cache, 0);
-        log_info(cpuLog, "Caché Reemplazo: Sale PID: %u, Página: %u", evicted->pid, evicted->page);
-        free(evicted->content);
-        free(evicted);
+    // Pasa al final del orden de LRU: las que eran más viejas que ella rejuvenecen un lugar.
+    uint16_t previousRank = victim->lruRank;
+    for (int way = 0; way < core->tlb.ways; way++) {
+        if (set[way].lruRank > previousRank)
+            set[way].lruRank--;
     }
+    victim->lruRank = core->tlb.ways - 1;
+
+    log_info(cpuLog, "TLB Prefetch: Entra PID: %u, Página: %u, Marco: %u", pid, page, frame);
+    return true;
+}
+
+// Arma la Caché de Páginas: los slots, un solo buffer con el contenido de todas las páginas, y el índice hash
+// (con al menos el doble de buckets que de entradas, en potencia de 2, así las cadenas quedan cortas y el costo no crece con ENTRADAS_CACHE):
+void page_cache_init(int entries, tCacheAlgorithm algorithm) {
+    uint32_t bucketCount = 1;
+    while (bucketCount < (uint32_t)entries * 2)
+        bucketCount <<= 1;
+
+    core->page_cache.entries = entries;
+    core->page_cache.algorithm = algorithm;
+    core->page_cache.slots = calloc(entries, sizeof(tPageCache));
+    core->page_cache.contents = calloc(entries, tamanioPagina);
+    core->page_cache.buckets = malloc(sizeof(int32_t) * bucketCount);
+    core->page_cache.bucketMask = bucketCount - 1;
+    core->page_cache.hits = core->page_cache.misses = core->page_cache.evictions = 0;
+    core->page_cache.writebacks = core->page_cache.flushMessages = core->page_cache.prefetchesUsed = 0;
+    core->page_cache.hasLastPid = false;
+
+    for (int i = 0; i < entries; i++)
+        core->page_cache.slots[i].content = (char*)core->page_cache.contents + (size_t)i * tamanioPagina;
+    page_cache_flush();
+}
+
+static inline int32_t* page_cache_bucket(uint32_t pid, uint32_t page) {
+    uint32_t hash = (page * 2654435761u) ^ (pid * 0x9E3779B9u);
+    return &core->page_cache.buckets[(hash ^ (hash >> 16)) & core->page_cache.bucketMask];
+}
 
-    tPageCache* new_entry = malloc(sizeof(tPageCache));
-    new_entry->pid = pid;
-    new_entry->page = page;
-    new_entry->content = malloc(tamanioPagina);
-    memcpy(new_entry->content, content, tamanioPagina);
+// Saca el slot de la cadena de su bucket:
+static void page_cache_unlink(int slotIndex) {
+    tPageCache* slot = &core->page_cache.slots[slotIndex];
+    int32_t* link = page_cache_bucket(slot->pid, slot->page);
+    while (*link != -1 && *link != slotIndex)
+        link = &core->page_cache.slots[*link].hashNext;
+    if (*link == slotIndex)
+        *link = slot->hashNext;
+    slot->hashNext = -1;
+}
+
+// Busca la página en la caché. Si está, le prende el bit de uso (y el de modificado si el acceso es una escritura):
+tPageCache* page_cache_lookup(uint32_t pid, uint32_t page, bool isWrite) {
+    if (!core->page_cache.slots) return NULL;
+
+    for (int32_t i = *page_cache_bucket(pid, page); i != -1; i = core->page_cache.slots[i].hashNext) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (slot->valid && slot->page == page && slot->pid == pid) {
+            slot->use = true;
+            if (isWrite)
+                slot->modified = true;
+            core->page_cache.hits++;
+            trace_flag(TRACE_CACHE_HIT);
+            if (slot->prefetched) {
+                slot->prefetched = false;
+                core->page_cache.prefetchesUsed++;
+            }
+            return slot;
+        }
+    }
+
+    core->page_cache.misses++;
+    trace_flag(TRACE_CACHE_MISS);
+    return NULL;
+}
+
+// Una vuelta del puntero buscando un slot con (uso, modificado) == (0, wantModified).
+// Si clearUse es verdadero, le apaga el bit de uso a los slots que saltea (segunda oportunidad).
+// Si onlyOwn es verdadero solo se consideran los slots del pid owner (reemplazo dentro de la cuota del proceso):
+static int page_cache_clock_pass(bool wantModified, bool matchModified, bool clearUse, bool onlyOwn, uint32_t owner) {
+    for (int step = 0; step < core->page_cache.entries; step++) {
+        int index = core->page_cache.clockHand;
+        tPageCache* slot = &core->page_cache.slots[index];
+        core->page_cache.clockHand = (core->page_cache.clockHand + 1) % core->page_cache.entries;
+
+        if (onlyOwn && (!slot->valid || slot->pid != owner))
+            continue;
+        if (!slot->use && (!matchModified || slot->modified == wantModified))
+            return index;
+        if (clearUse)
+            slot->use = false;
+    }
+    return -1;
+}
+
+// Cuántos slots ocupa el proceso (solo se cuenta si hay cuota):
+static int page_cache_owned(uint32_t pid) {
+    int owned = 0;
+    for (int i = 0; i < core->page_cache.entries; i++) {
+        if (core->page_cache.slots[i].valid && core->page_cache.slots[i].pid == pid)
+            owned++;
+    }
+    return owned;
+}
+
+// Elige la víctima según el algoritmo:
+// CLOCK: la primera con uso en 0, apagando el bit de uso de las que saltea.
+// CLOCK-M: 1) busca (0,0) sin tocar nada, 2) busca (0,1) apagando el bit de uso de las que saltea, y repite hasta encontrar.
+// Si pid ya llegó a su cuota, el algoritmo corre solo sobre sus propios slots:
+static int page_cache_choose_victim(uint32_t pid) {
+    bool onlyOwn = core->page_cache.quota > 0 && page_cache_owned(pid) >= core->page_cache.quota;
+
+    for (int i = 0; i < core->page_cache.entries && !onlyOwn; i++) {
+        if (!core->page_cache.slots[i].valid)
+            return i;
+    }
+
+    if (core->page_cache.algorithm == CACHE_CLOCK) {
+        int victim = page_cache_clock_pass(false, false, true, onlyOwn, pid);
+        return victim != -1 ? victim : page_cache_clock_pass(false, false, true, onlyOwn, pid);
+    }
+
+    while (true) {
+        int victim = page_cache_clock_pass(false, true, false, onlyOwn, pid);
+        if (victim == -1)
+            victim = page_cache_clock_pass(true, true, true, onlyOwn, pid);
+        if (victim != -1)
+            return victim;
+    }
+}
+
+// Agrega la página a la caché (reemplazando si está llena) y devuelve su slot:
+tPageCache* page_cache_add(uint32_t pid, uint32_t page, uint32_t frame, void* content) {
+    if (!core->page_cache.slots) return NULL;
+
+    int index = page_cache_choose_victim(pid);
+    tPageCache* slot = &core->page_cache.slots[index];
+
+    if (slot->valid) {
+        core->page_cache.evictions++;
+        log_info(cpuLog, "Caché Reemplazo: Sale PID: %u, Página: %u", slot->pid, slot->page);
+        // Si la víctima está modificada, se aprovecha el mismo mensaje para mandar todas las páginas modificadas de su proceso:
+        if (core->page_cache.writeBack && slot->modified)
+            page_cache_flush_process(slot->pid);
+        page_cache_unlink(index);
+    }
+
+    slot->pid = pid;
+    slot->page = page;
+    slot->frame = frame;
+    slot->valid = true;
+    slot->use = true;
+    slot->modified = false;
+    slot->prefetched = false;
+    memcpy(slot->content, content, tamanioPagina);
+
+    int32_t* bucket = page_cache_bucket(pid, page);
+    slot->hashNext = *bucket;
+    *bucket = index;
 
-    list_add(page_cache, new_entry);
     log_info(cpuLog, "Caché Add: Entra PID: %u, Página: %u", pid, page);
+    return slot;
+}
+
+// Indica si la página está en la caché, sin contarlo como acceso ni tocar sus bits. La usa el prefetcher:
+bool page_cache_probe(uint32_t pid, uint32_t page) {
+    if (!core->page_cache.slots) return false;
+
+    for (int32_t i = *page_cache_bucket(pid, page); i != -1; i = core->page_cache.slots[i].hashNext) {
+        if (core->page_cache.slots[i].valid && core->page_cache.slots[i].page == page && core->page_cache.slots[i].pid == pid)
+            return true;
+    }
+    return false;
+}
+
+// Agrega una página traída por el prefetcher con la menor prioridad: solo ocupa un slot libre, el de otra página prefetcheada que no se usó,
+// o uno limpio con el bit de uso apagado (el que CLOCK sacaría de todos modos). Entra con el bit de uso apagado para que CLOCK / CLOCK-M la elijan primero.
+// Retorna false si no había lugar:
+bool page_cache_add_prefetched(uint32_t pid, uint32_t page, uint32_t frame, void* content) {
+    if (!core->page_cache.slots) return false;
+    if (core->page_cache.quota > 0 && page_cache_owned(pid) >= core->page_cache.quota) return false;
+
+    int index = -1;
+    for (int i = 0; i < core->page_cache.entries && index == -1; i++) {
+        if (!core->page_cache.slots[i].valid)
+            index = i;
+    }
+    for (int i = 0; i < core->page_cache.entries && index == -1; i++) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (slot->prefetched || (!slot->use && !slot->modified))
+            index = i;
+    }
+    if (index == -1)
+        return false;
+
+    tPageCache* slot = &core->page_cache.slots[index];
+    if (slot->valid)
+        page_cache_unlink(index);
+
+    slot->pid = pid;
+    slot->page = page;
+    slot->frame = frame;
+    slot->valid = true;
+    slot->use = false;
+    slot->modified = false;
+    slot->prefetched = true;
+    memcpy(slot->content, content, tamanioPagina);
+
+    int32_t* bucket = page_cache_bucket(pid, page);
+    slot->hashNext = *bucket;
+    *bucket = index;
+
+    log_info(cpuLog, "Caché Prefetch: Entra PID: %u, Página: %u", pid, page);
+    return true;
 }
 
 void page_cache_invalidate(uint32_t pid, uint32_t page) {
-    if (!page_cache) return;
+    if (!core->page_cache.slots) return;
+
+    for (int32_t i = *page_cache_bucket(pid, page); i != -1; i = core->page_cache.slots[i].hashNext) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (slot->valid && slot->page == page && slot->pid == pid) {
+            if (core->page_cache.writeBack && slot->modified)
+                page_cache_flush_process(pid);
+            page_cache_unlink(i);
+            slot->valid = false;
+            slot->use = false;
+            slot->modified = false;
+            log_info(cpuLog, "Caché Invalidate: PID: %u, Página: %u", pid, page);
+            return;
+        }
+    }
+}
 
-    /*
-    bool find_condition(void* element) {
-        tPageCache* entry = (tPageCache*) element;
-        return entry->pid == pid && entry->page == page;
+// Manda a Memoria, en un solo mensaje, todas las páginas modificadas del proceso que están en la caché, y les apaga el bit de modificado.
+// Retorna la cantidad de páginas escritas, o -1 si Memoria no confirmó la escritura (en ese caso las páginas siguen modificadas):
+int page_cache_flush_process(uint32_t pid) {
+    if (!core->page_cache.slots || !core->page_cache.writeBack) return 0;
+
+    uint32_t physicalAddresses[core->page_cache.entries];
+    void* contents[core->page_cache.entries];
+    int slotIndexes[core->page_cache.entries];
+    int count = 0;
+
+    for (int i = 0; i < core->page_cache.entries; i++) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (slot->valid && slot->modified && slot->pid == pid) {
+            physicalAddresses[count] = slot->frame * tamanioPagina;
+            contents[count] = slot->content;
+            slotIndexes[count] = i;
+            count++;
+        }
     }
+    if (count == 0) return 0;
 
-    void destroyer(void* element) {
-        tPageCache* entry = (tPageCache*) element;
-        free(entry->content);
-        free(entry);
+    if (memory_write_pages(pid, physicalAddresses, contents, count) != 0) {
+        log_error(cpuLog, "PID: %u - No se pudieron escribir en Memoria las %d páginas modificadas de la caché", pid, count);
+        return -1;
     }
-    */
-    /* if(list_remove_and_destroy_by_condition(page_cache, find_condition, destroyer)){
-        log_info(cpuLog, "Caché Invalidate: PID: %u, Página: %u eliminada por escritura.", pid, page);
-    } */
+
+    for (int i = 0; i < count; i++)
+        core->page_cache.slots[slotIndexes[i]].modified = false;
+    core->page_cache.writebacks += count;
+    core->page_cache.flushMessages++;
+
+    log_info(cpuLog, "PID: %u - Caché Write-Back: %d páginas modificadas escritas en Memoria", pid, count);
+    return count;
+}
+
+// Se llama al recibir cada instrucción: si el proceso que ejecuta no es el de la instrucción anterior,
+// hubo un cambio de contexto y se bajan a Memoria las páginas modificadas del proceso que salió:
+void page_cache_switch_process(uint32_t pid) {
+    if (!core->page_cache.slots || !core->page_cache.writeBack) return;
+
+    if (core->page_cache.hasLastPid && core->page_cache.lastPid != pid)
+        page_cache_flush_process(core->page_cache.lastPid);
+    core->page_cache.lastPid = pid;
+    core->page_cache.hasLastPid = true;
+}
+
+// Invalida solo las entradas del proceso (por ejemplo cuando termina), sin tocar las del resto:
+void tlb_invalidate_process(uint32_t pid) {
+    if (!core->tlb.entries) return;
+
+    for (int i = 0; i < core->tlb.sets * core->tlb.ways; i++) {
+        if (core->tlb.entries[i].valid && core->tlb.entries[i].pid == pid) {
+            core->tlb.entries[i].valid = false;
+            core->tlb.entries[i].prefetched = false;
+        }
+    }
+    log_info(cpuLog, "TLB: invalidadas las entradas del PID %u.", pid);
+}
+
+// Invalida las páginas del proceso en la caché; en write-back antes se mandan a Memoria las que estén modificadas:
+void page_cache_invalidate_process(uint32_t pid) {
+    if (!core->page_cache.slots) return;
+
+    page_cache_flush_process(pid);
+    for (int i = 0; i < core->page_cache.entries; i++) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (slot->valid && slot->pid == pid) {
+            page_cache_unlink(i);
+            slot->valid = false;
+            slot->use = false;
+            slot->modified = false;
+            slot->prefetched = false;
+        }
+    }
+    if (core->page_cache.hasLastPid && core->page_cache.lastPid == pid)
+        core->page_cache.hasLastPid = false;
+    log_info(cpuLog, "Caché de Páginas: invalidadas las páginas del PID %u.", pid);
+}
+
+// Cuando un proceso termina, sus traducciones, páginas y tablas intermedias ya no sirven: se liberan para los demás procesos.
+// Los cambios de contexto no invalidan nada, porque cada entrada lleva su pid y un proceso que vuelve a la CPU encuentra su estado caliente:
+void mmu_invalidate_process(uint32_t pid) {
+    prefetch_invalidate();
+    tlb_invalidate_process(pid);
+    page_cache_invalidate_process(pid);
+    walk_cache_invalidate_process(pid);
+}
+
+static inline bool shootdown_matches(uint32_t pid, uint32_t first, uint32_t count, uint32_t entryPid, uint32_t entryPage) {
+    return entryPid == pid && entryPage - first < count;
+}
+
+// Shootdown de Memoria (ver memoriaShootdown.c) sobre el núcleo actual: invalida las traducciones y las páginas de la caché que
+// apuntan a lo que Memoria va a liberar, bajando antes las modificadas, y también las tablas intermedias del proceso.
+// Lo llama el hilo de shootdown con el mmuMutex del núcleo tomado:
+void mmu_shootdown(uint32_t pid, uint32_t first, uint32_t count) {
+    int tlbEntries = 0, cachePages = 0;
+    prefetch_invalidate();
+
+    for (int i = 0; core->tlb.entries && i < core->tlb.sets * core->tlb.ways; i++) {
+        tTlb* entry = &core->tlb.entries[i];
+        if (entry->valid && shootdown_matches(pid, first, count, entry->pid, entry->page)) {
+            entry->valid = false;
+            entry->prefetched = false;
+            tlbEntries++;
+        }
+    }
+
+    for (int i = 0; core->page_cache.slots && i < core->page_cache.entries; i++) {
+        tPageCache* slot = &core->page_cache.slots[i];
+        if (!slot->valid || !shootdown_matches(pid, first, count, slot->pid, slot->page))
+            continue;
+        if (core->page_cache.writeBack && slot->modified)
+            page_cache_flush_process(slot->pid);
+        page_cache_unlink(i);
+        slot->valid = false;
+        slot->use = false;
+        slot->modified = false;
+        slot->prefetched = false;
+        cachePages++;
+    }
+
+    walk_cache_invalidate_process(pid);
+
+    log_info(cpuLog, "CPU %d: shootdown de Memoria, %d entradas de TLB y %d páginas de la caché invalidadas.", core->cpuId, tlbEntries, cachePages);
 }
 
 int memory_get_frame(int, int, void*) { return 0;}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <commons/collections/list.h>
 #include <commons/collections/queue.h>
 #include <stdint.h>
+#include <utils.h>
 
 typedef struct {
     int page_number;
@@ -17,19 +18,96 @@ typedef struct {
     t_list* page_table; // list of tPageEntry*
 } tProcessMemory;
 
+// Entrada de la TLB. lruRank es la antigüedad de la entrada dentro de su conjunto (0 = la más recientemente usada).
+// prefetched queda prendido mientras una entrada traída por el prefetcher no se haya usado:
 typedef struct {
     uint32_t pid;
     uint32_t page;
     uint32_t frame;
+    uint16_t lruRank;
     bool valid;
+    bool prefetched;
 } tTlb;
 
+// TLB asociativa por conjuntos: un array plano de sets * ways entradas, donde el conjunto de una página sale de un hash de (pid, página).
+// Una búsqueda solo recorre las ways de un conjunto, así que su costo no crece con ENTRADAS_TLB.
+// Con LRU se usa lruRank de cada entrada, con FIFO el índice de la próxima víctima de cada conjunto (fifoNext).
+// El pid de cada entrada funciona como identificador de espacio de direcciones: las entradas de un proceso sobreviven a los cambios de contexto,
+// y quota limita cuántas vías de un conjunto puede ocupar un mismo pid (0 = sin límite):
+typedef struct {
+    tTlb* entries;
+    uint16_t* fifoNext;
+    int sets;
+    int ways;
+    int quota;
+    bool lru;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t prefetchesUsed;
+} tTlbCache;
+
+// Entrada (slot) de la Caché de Páginas. content apunta al bloque de la página dentro de un único buffer de ENTRADAS_CACHE páginas,
+// hashNext encadena los slots que caen en el mismo bucket del índice (-1 es el fin de la cadena):
 typedef struct {
     uint32_t pid;
     uint32_t page;
+    uint32_t frame;
+    bool valid;
+    bool use;
+    bool modified;
+    bool prefetched;
+    int32_t hashNext;
     void* content;
 } tPageCache;
 
+typedef enum {
+    CACHE_CLOCK,
+    CACHE_CLOCK_M
+} tCacheAlgorithm;
+
+// Caché de Páginas: array fijo de slots, índice hash por (pid, página) y puntero de reemplazo (clockHand) para CLOCK / CLOCK-M.
+// Con quota un pid no puede ocupar más de esa cantidad de slots: al llegar al límite reemplaza una página propia en vez de una de otro proceso.
+// Con writeBack las escrituras quedan solo en la caché (bit de modificado) y llegan a Memoria en tandas: al reemplazar la página,
+// al cambiar de proceso (lastPid), en EXIT y en DUMP_MEMORY. writebacks cuenta páginas escritas y flushMessages los mensajes usados:
+typedef struct {
+    tPageCache* slots;
+    void* contents;
+    int32_t* buckets;
+    uint32_t bucketMask;
+    int entries;
+    int clockHand;
+    tCacheAlgorithm algorithm;
+    int quota;
+    bool writeBack;
+    uint32_t lastPid;
+    bool hasLastPid;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t writebacks;
+    uint64_t flushMessages;
+    uint64_t prefetchesUsed;
+} tPageCacheState;
+
+// Entrada de la caché de tablas intermedias: para un nivel, el prefijo de índices de la página (pid, prefix) lleva a la tabla del nivel siguiente:
+typedef struct {
+    uint32_t pid;
+    uint32_t prefix;
+    uint64_t table;
+    bool valid;
+} tWalkCacheEntry;
+
+// Caché de tablas intermedias (como las paging-structure caches de x86): entriesPerLevel entradas de mapeo directo por cada nivel 1..levels-1,
+// así un TLB miss arranca la recorrida desde el nivel más profundo que ya conoce. hits/misses se cuentan por nivel (índice level-1):
+typedef struct {
+    tWalkCacheEntry* entries;
+    int entriesPerLevel;
+    int levels;
+    uint64_t* hits;
+    uint64_t* misses;
+} tWalkCache;
+
 typedef struct {
     uint32_t physical_address;
     uint32_t size;
@@ -42,13 +120,6 @@ typedef enum {
 
 extern uint32_t page_size;
 
-// TLB
-extern t_queue* tlb;
-extern t_list* tlb_as_list;
-
-// Caché de Páginas
-extern t_list* page_cache;
-
 void mmu_init();
 tMmuStatus mmu_read(uint32_t, uint32_t, void*);
 tMmuStatus mmu_write(uint32_t, uint32_t, void*);
@@ -58,16 +129,35 @@ tMmuStatus translate_address(uint32_t, uint32_t, uint32_t*);
 tMmuStatus fetch_page_from_memory(uint32_t, uint32_t, uint32_t, void**);
 
 // Funciones de TLB
+#define TLB_DEFAULT_WAYS 8
+void tlb_init(int entries, int ways, bool lru);
 bool tlb_lookup(uint32_t, uint32_t, uint32_t*);
 void tlb_add(uint32_t, uint32_t, uint32_t);
+bool tlb_probe(uint32_t, uint32_t, uint32_t*);
+bool tlb_has_room(uint32_t, uint32_t);
+bool tlb_add_prefetched(uint32_t, uint32_t, uint32_t, bool);
+void tlb_invalidate_process(uint32_t);
 
 // Funciones de Caché de Páginas
-tPageCache* page_cache_lookup(uint32_t, uint32_t);
-void page_cache_add(uint32_t, uint32_t, void*);
+void page_cache_init(int entries, tCacheAlgorithm algorithm);
+tPageCache* page_cache_lookup(uint32_t, uint32_t, bool);
+tPageCache* page_cache_add(uint32_t, uint32_t, uint32_t, void*);
 void page_cache_invalidate(uint32_t, uint32_t);
+bool page_cache_probe(uint32_t, uint32_t);
+bool page_cache_add_prefetched(uint32_t, uint32_t, uint32_t, void*);
+int page_cache_flush_process(uint32_t);
+void page_cache_switch_process(uint32_t);
+void page_cache_invalidate_process(uint32_t);
+
+void mmu_invalidate_process(uint32_t);
+void mmu_shootdown(uint32_t pid, uint32_t first, uint32_t count);
 
 void tlb_flush();
 
+// Funciones de la caché de tablas intermedias
+void walk_cache_init(int entriesPerLevel, int levels);
+void walk_cache_invalidate_process(uint32_t);
+
 void page_cache_flush();
 void mmu_init(void);
 void mmu_destroy();
@@ -0,0 +1,396 @@
+#include "cpu.h"
+#include "mmu.h"
+#include "mmuPrefetch.h"
+#include <math.h>
+
+// El núcleo decide qué páginas adelantar justo después de cada acceso de un READ / WRITE (o de cada instrucción, con lookahead), pero no
+// las trae: deja la tanda en una cola y sigue con la próxima instrucción. Un solo hilo de prefetch para toda la CPU atiende la cola con su
+// propia conexión con Memoria, fuera del mmuMutex de los núcleos, así los pedidos del prefetch nunca demoran el camino de las instrucciones.
+// Para que traer K páginas no cueste K idas y vueltas, los pedidos van juntos en un CPU_TO_MEMORIA_BATCH: uno con todas las entradas
+// de un nivel de la tabla, y uno con todas las lecturas de páginas.
+
+// Tanda de páginas a adelantar para un núcleo, con las generaciones del núcleo al momento de pedirla (ver prefetch_serve):
+typedef struct {
+    tCpuCore* core;
+    uint32_t pid;
+    uint32_t pages[PREFETCH_BATCH_PAGES];
+    int count;
+    bool certain;
+    bool sequential;
+    uint64_t generation;
+    uint64_t writes;
+} tPrefetchRequest;
+
+static t_queue* prefetchQueue; // tPrefetchRequest*
+static pthread_mutex_t prefetchQueueMutex = PTHREAD_MUTEX_INITIALIZER;
+static sem_t prefetchQueueReady;
+static int prefetchSocket = -1; // -1 si el hilo de prefetch no está corriendo
+
+static void* prefetchThread(void* unused);
+
+void prefetch_init(int distance, int lookahead, bool pages) {
+    memset(&core->prefetcher, 0, sizeof(tPrefetcher));
+    core->prefetcher.distance = distance < PREFETCH_BATCH_PAGES ? distance : PREFETCH_BATCH_PAGES;
+    core->prefetcher.lookahead = lookahead;
+    core->prefetcher.pages = pages;
+}
+
+// Levanta el hilo de prefetch con su conexión con Memoria. Se llama una vez, si algún núcleo va a adelantar páginas:
+bool prefetch_start(void) {
+    int connectionSocket = createConnectionSocket(getCpuConfig()->IP_MEMORIA, getCpuConfig()->PUERTO_MEMORIA);
+    if (connectionSocket == -1 || !handshakeFromPrefetchToMemoria(connectionSocket)) {
+        log_error(cpuLog, "Prefetch: no se pudo abrir su conexión con Memoria, queda deshabilitado.");
+        if (connectionSocket != -1)
+            close(connectionSocket);
+        return false;
+    }
+
+    prefetchQueue = queue_create();
+    sem_init(&prefetchQueueReady, 0, 0);
+    prefetchSocket = connectionSocket;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, prefetchThread, NULL);
+    pthread_detach(thread);
+    log_info(cpuLog, "Hilo de prefetch creado con su propia conexión con Memoria (socket %d).", connectionSocket);
+    return true;
+}
+
+// El núcleo invalidó traducciones (shootdown o fin de un proceso): lo que esté trayendo el hilo de prefetch ya no sirve.
+// Se llama con el mmuMutex del núcleo tomado:
+void prefetch_invalidate(void) {
+    core->prefetcher.generation++;
+    for (int i = 0; i < PREFETCH_STREAMS; i++)
+        core->prefetcher.streams[i].endPage = UINT32_MAX;
+}
+
+// Stream del proceso, o NULL si no se lo está siguiendo:
+static tPrefetchStream* streamOf(uint32_t pid) {
+    tPrefetchStream* stream = &core->prefetcher.streams[pid % PREFETCH_STREAMS];
+    return stream->valid && stream->pid == pid ? stream : NULL;
+}
+
+// El núcleo escribió datos: el contenido de páginas leído antes por el hilo de prefetch puede estar viejo. Con el mmuMutex tomado:
+void prefetch_note_write(void) {
+    core->prefetcher.writes++;
+}
+
+// Recorre en paralelo las tablas de páginas de las páginas pedidas, nivel por nivel, y deja en frames el marco de cada una.
+// alive[i] queda en false para las páginas cuya traducción no existe (por ejemplo, las que quedan fuera del proceso).
+// Lo usa el hilo de prefetch, por su conexión. Retorna 0, o -1 si se perdió la conexión:
+static int prefetch_walk(uint32_t pid, uint32_t* pages, uint32_t* frames, bool* alive, int count) {
+    uint64_t tables[count];
+    tMemoriaBatchItem items[count];
+    memset(tables, 0, sizeof(tables));
+
+    for (int level = 1; level <= (int)cantidadNiveles; level++) {
+        int divisor = pow(entradasPorTabla, cantidadNiveles - level);
+
+        int itemCount = 0;
+        for (int i = 0; i < count; i++) {
+            if (alive[i])
+                items[itemCount++] = (tMemoriaBatchItem){ .kind = MEMORIA_BATCH_PAGE_TABLE_ENTRY, .table = tables[i], .level = level,
+                                                          .index = (pages[i] / divisor) % entradasPorTabla };
+        }
+        if (itemCount == 0)
+            return 0;
+        if (memory_batch_on(prefetchSocket, pid, items, itemCount) != 0)
+            return -1;
+
+        for (int i = 0, item = 0; i < count; i++) {
+            if (!alive[i])
+                continue;
+            uint64_t entry = items[item++].entry;
+            // En los niveles intermedios una tabla que no existe llega como 0 (puntero nulo):
+            if (entry == (uint64_t)-1 || (level < (int)cantidadNiveles && entry == 0))
+                alive[i] = false;
+            else if (level < (int)cantidadNiveles)
+                tables[i] = entry;
+            else
+                frames[i] = (uint32_t)entry;
+        }
+    }
+    return 0;
+}
+
+// Páginas de la lista a las que les falta algo: la traducción en la TLB o, trayendo páginas, el contenido en la Caché.
+// Las compacta al principio y retorna cuántas quedan:
+static int keepMissingPages(uint32_t pid, uint32_t* pages, int count) {
+    int missing = 0;
+    for (int i = 0; i < count; i++) {
+        // Una traducción que falta solo cuenta si hay lugar para ella sin desalojar entradas en uso:
+        uint32_t frame;
+        bool translated = core->tlb.entries && tlb_probe(pid, pages[i], &frame);
+        bool cached = core->prefetcher.pages && core->page_cache.slots && page_cache_probe(pid, pages[i]);
+        if ((core->tlb.entries && !translated && tlb_has_room(pid, pages[i]))
+            || (core->prefetcher.pages && core->page_cache.slots && !cached))
+            pages[missing++] = pages[i];
+    }
+    return missing;
+}
+
+// Deja la tanda en la cola del hilo de prefetch, con las generaciones actuales del núcleo. Si la cola está llena se descarta (es solo una pista):
+static void prefetch_enqueue(uint32_t pid, uint32_t* pages, int count, bool certain, bool sequential) {
+    if (prefetchSocket == -1 || count == 0)
+        return;
+
+    tPrefetchRequest* request = malloc(sizeof(tPrefetchRequest));
+    request->core = core;
+    request->pid = pid;
+    request->count = count;
+    request->certain = certain;
+    request->sequential = sequential;
+    request->generation = core->prefetcher.generation;
+    request->writes = core->prefetcher.writes;
+    memcpy(request->pages, pages, sizeof(uint32_t) * count);
+
+    pthread_mutex_lock(&prefetchQueueMutex);
+    bool full = queue_size(prefetchQueue) >= PREFETCH_QUEUE_MAX;
+    if (!full)
+        queue_push(prefetchQueue, request);
+    pthread_mutex_unlock(&prefetchQueueMutex);
+
+    if (full) {
+        core->prefetcher.dropped++;
+        free(request);
+        return;
+    }
+    sem_post(&prefetchQueueReady);
+}
+
+// Hilo de prefetch: atiende una tanda. Recorre las tablas y lee las páginas por su propia conexión, sin tomar el mmuMutex del núcleo;
+// solo lo toma al final para cargar lo que trajo en la TLB / Caché, y lo descarta si mientras tanto el núcleo invalidó (shootdown o
+// fin del proceso: cambió generation) o, el contenido de las páginas, si escribió (cambió writes).
+// Retorna false si se perdió la conexión con Memoria:
+static bool prefetch_serve(tPrefetchRequest* request) {
+    tCpuCore* target = request->core;
+    int count = request->count;
+    uint32_t frames[count];
+    bool alive[count];
+    for (int i = 0; i < count; i++)
+        alive[i] = true;
+
+    if (prefetch_walk(request->pid, request->pages, frames, alive, count) != 0)
+        return false;
+
+    // Una página sin traducción es una página fuera del proceso: en un salto constante, las que siguen también lo están
+    for (int i = 0; request->sequential && i < count; i++) {
+        if (!alive[i]) {
+            for (int j = i + 1; j < count; j++)
+                alive[j] = false;
+            break;
+        }
+    }
+
+    bool fetch[count];
+    int toFetch = 0;
+    for (int i = 0; i < count; i++) {
+        fetch[i] = alive[i] && target->prefetcher.pages && target->page_cache.slots;
+        toFetch += fetch[i];
+    }
+
+    tMemoriaBatchItem items[toFetch > 0 ? toFetch : 1];
+    void* contents = NULL;
+    if (toFetch > 0) {
+        contents = malloc((size_t)toFetch * tamanioPagina);
+        for (int i = 0, item = 0; i < count; i++) {
+            if (fetch[i]) {
+                items[item] = (tMemoriaBatchItem){ .kind = MEMORIA_BATCH_READ, .address = frames[i] * tamanioPagina, .size = tamanioPagina,
+                                                   .data = (char*)contents + (size_t)item * tamanioPagina };
+                item++;
+            }
+        }
+        if (memory_batch_on(prefetchSocket, request->pid, items, toFetch) != 0) {
+            free(contents);
+            return false;
+        }
+    }
+
+    pthread_mutex_lock(&target->mmuMutex);
+    core = target;
+    if (request->generation != core->prefetcher.generation) {
+        core->prefetcher.discarded++;
+    } else {
+        bool contentValid = request->writes == core->prefetcher.writes;
+        tPrefetchStream* stream = streamOf(request->pid);
+        for (int i = 0, item = 0; i < count; i++) {
+            // Las páginas de un proceso están todas mapeadas desde la 0, así que la que no tiene traducción marca dónde termina:
+            // no se la vuelve a pedir (ni a las que siguen)
+            if (!alive[i]) {
+                if (stream && request->pages[i] < stream->endPage)
+                    stream->endPage = request->pages[i];
+                continue;
+            }
+            uint32_t frame;
+            if (core->tlb.entries && !tlb_probe(request->pid, request->pages[i], &frame)
+                && tlb_add_prefetched(request->pid, request->pages[i], frames[i], request->certain))
+                core->prefetcher.translationsIssued++;
+            if (fetch[i]) {
+                void* content = items[item++].data;
+                if (contentValid && !page_cache_probe(request->pid, request->pages[i])
+                    && page_cache_add_prefetched(request->pid, request->pages[i], frames[i], content))
+                    core->prefetcher.pagesIssued++;
+            }
+        }
+    }
+    core = NULL;
+    pthread_mutex_unlock(&target->mmuMutex);
+
+    free(contents);
+    return true;
+}
+
+static void* prefetchThread(void* unused) {
+    while (true) {
+        sem_wait(&prefetchQueueReady);
+        pthread_mutex_lock(&prefetchQueueMutex);
+        tPrefetchRequest* request = queue_pop(prefetchQueue);
+        pthread_mutex_unlock(&prefetchQueueMutex);
+
+        bool served = prefetch_serve(request);
+        free(request);
+        if (!served) {
+            log_error(cpuLog, "Prefetch: se perdió la conexión con Memoria, se deja de adelantar páginas.");
+            close(prefetchSocket);
+            prefetchSocket = -1;
+            return NULL;
+        }
+    }
+}
+
+// Se llama después de cada acceso de la MMU a una página. Un salto de 1 página dispara el prefetch enseguida (acceso secuencial),
+// cualquier otro salto recién cuando se repite dos veces seguidas:
+void prefetch_on_access(uint32_t pid, uint32_t page) {
+    if (core->prefetcher.distance <= 0)
+        return;
+
+    tPrefetchStream* stream = &core->prefetcher.streams[pid % PREFETCH_STREAMS];
+    if (!stream->valid || stream->pid != pid) {
+        stream->pid = pid;
+        stream->lastPage = page;
+        stream->stride = 0;
+        stream->confidence = 0;
+        stream->endPage = UINT32_MAX;
+        stream->valid = true;
+        return;
+    }
+    if (page == stream->lastPage)
+        return;
+
+    int32_t stride = (int32_t)(page - stream->lastPage);
+    if (stride == stream->stride) {
+        stream->confidence++;
+    } else {
+        stream->stride = stride;
+        stream->confidence = 0;
+    }
+    stream->lastPage = page;
+
+    if (stride != 1 && stream->confidence < 1)
+        return;
+
+    uint32_t pages[core->prefetcher.distance];
+    int count = 0;
+    for (int i = 1; i <= core->prefetcher.distance; i++) {
+        int64_t next = (int64_t)page + (int64_t)stride * i;
+        if (next < 0 || next >= stream->endPage)
+            break;
+        pages[count++] = (uint32_t)next;
+    }
+    // Las que ya están no se vuelven a pedir, pero la primera que falta puede venir después de una que está
+    count = keepMissingPages(pid, pages, count);
+    if (count == 0)
+        return;
+
+    core->prefetcher.batches++;
+    log_info(cpuLog, "PID: %u - Prefetch: salto de %d páginas detectado, pidiendo %d páginas desde la %u", pid, stride, count, pages[0]);
+    prefetch_enqueue(pid, pages, count, false, true);
+}
+
+// Agrega a pages las páginas de [address, address + size) que todavía no estén, hasta max. Retorna la nueva cantidad:
+static int addOperandPages(uint32_t* pages, int count, int max, uint32_t address, uint32_t size) {
+    if (size == 0)
+        return count;
+    uint64_t last = ((uint64_t)address + size - 1) / tamanioPagina;
+    for (uint64_t page = address / tamanioPagina; page <= last && count < max; page++) {
+        bool seen = false;
+        for (int i = 0; i < count && !seen; i++)
+            seen = pages[i] == page;
+        if (!seen)
+            pages[count++] = (uint32_t)page;
+    }
+    return count;
+}
+
+// Lookahead de operandos: los operandos del pseudocódigo son literales, así que ya decodificadas se sabe qué direcciones van a tocar
+// las próximas instrucciones. Después de cada instrucción se recorren a lo sumo lookahead instrucciones desde el PC, por donde va a pasar
+// la ejecución (siguiendo los GOTO), solo entre las que ya están decodificadas en la caché de instrucciones (no se pide nada a Memoria
+// para mirar), hasta una instrucción que deja la CPU o que no está en la caché. Las páginas de sus READ / WRITE se piden en una tanda al hilo de prefetch:
+// solo se llenan la TLB y la Caché con lo mismo que traería el acceso (nunca se escribe), y los pedidos pagan su retardo de Memoria.
+void prefetch_lookahead(uint32_t pid, uint32_t pc) {
+    if (core->prefetcher.lookahead <= 0 || !core->instruction_cache.entries)
+        return;
+    if (!core->tlb.entries && (!core->prefetcher.pages || !core->page_cache.slots))
+        return;
+
+    // Se juntan solo las páginas más cercanas que entran en la mitad de la TLB (y de la Caché, si se traen páginas): si la recorrida
+    // abarca más páginas de las que caben, traer las lejanas echaría a las que la ejecución va a usar antes.
+    int max = PREFETCH_BATCH_PAGES;
+    if (core->tlb.entries && core->tlb.sets * core->tlb.ways / 2 < max)
+        max = core->tlb.sets * core->tlb.ways / 2;
+    if (core->prefetcher.pages && core->page_cache.slots && core->page_cache.entries / 2 < max)
+        max = core->page_cache.entries / 2;
+    if (max < 1)
+        max = 1;
+
+    uint32_t pages[PREFETCH_BATCH_PAGES];
+    int count = 0;
+    for (int i = 0; i < core->prefetcher.lookahead && count < max; i++) {
+        tDecodedInstruction* ahead = instruction_cache_peek(pid, pc);
+        if (!ahead)
+            break;
+        if (ahead->operation == READ)
+            count = addOperandPages(pages, count, max, (uint32_t)ahead->args[0], (uint32_t)ahead->args[1]);
+        else if (ahead->operation == WRITE)
+            count = addOperandPages(pages, count, max, (uint32_t)ahead->args[0], strlen(ahead->params[1]) + 1);
+        else if (ahead->operation != NOOP && ahead->operation != GOTO)
+            break;
+        pc = ahead->operation == GOTO ? (uint32_t)ahead->args[0] : pc + 1;
+    }
+
+    // Las páginas que ya se sabe que están fuera del proceso no se piden:
+    tPrefetchStream* stream = streamOf(pid);
+    int inside = 0;
+    for (int i = 0; i < count; i++) {
+        if (!stream || pages[i] < stream->endPage)
+            pages[inside++] = pages[i];
+    }
+
+    // Solo vale la pena la tanda si falta algo: la traducción en la TLB o, trayendo páginas, el contenido en la Caché:
+    int missing = keepMissingPages(pid, pages, inside);
+    if (missing == 0)
+        return;
+
+    core->prefetcher.lookaheadBatches++;
+    log_info(cpuLog, "PID: %u - Lookahead: pidiendo %d páginas de los próximos READ / WRITE desde la %u", pid, missing, pages[0]);
+    prefetch_enqueue(pid, pages, missing, true, false);
+}
+
+// Precisión: de lo que se trajo, cuánto se usó. Cobertura: de los accesos que habrían sido miss, cuántos resolvió el prefetch:
+void prefetch_report(void) {
+    if (core->prefetcher.distance <= 0 && core->prefetcher.lookahead <= 0)
+        return;
+
+    log_info(cpuLog, "Prefetch: %lu tandas por salto y %lu por lookahead (%lu descartadas con la cola llena, %lu invalidadas antes de llegar).",
+             (unsigned long)core->prefetcher.batches, (unsigned long)core->prefetcher.lookaheadBatches,
+             (unsigned long)core->prefetcher.dropped, (unsigned long)core->prefetcher.discarded);
+    log_info(cpuLog, "Prefetch: TLB: %lu traducciones traídas, %lu usadas (precisión %.1f%%, cobertura %.1f%%).",
+             (unsigned long)core->prefetcher.translationsIssued, (unsigned long)core->tlb.prefetchesUsed,
+             core->prefetcher.translationsIssued ? 100.0 * core->tlb.prefetchesUsed / core->prefetcher.translationsIssued : 0.0,
+             core->tlb.prefetchesUsed + core->tlb.misses ? 100.0 * core->tlb.prefetchesUsed / (core->tlb.prefetchesUsed + core->tlb.misses) : 0.0);
+    if (core->prefetcher.pages)
+        log_info(cpuLog, "Prefetch: Caché: %lu páginas traídas, %lu usadas (precisión %.1f%%, cobertura %.1f%%).",
+                 (unsigned long)core->prefetcher.pagesIssued, (unsigned long)core->page_cache.prefetchesUsed,
+                 core->prefetcher.pagesIssued ? 100.0 * core->page_cache.prefetchesUsed / core->prefetcher.pagesIssued : 0.0,
+                 core->page_cache.prefetchesUsed + core->page_cache.misses ? 100.0 * core->page_cache.prefetchesUsed / (core->page_cache.prefetchesUsed + core->page_cache.misses) : 0.0);
+}
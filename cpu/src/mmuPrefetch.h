@@ -0,0 +1,53 @@
+#ifndef CPU_MMU_PREFETCH_H
+#define CPU_MMU_PREFETCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cantidad de procesos cuyo patrón de acceso se sigue a la vez (mapeo directo por pid)
+#define PREFETCH_STREAMS 8
+// Páginas que lleva, como mucho, una tanda de prefetch (por salto o por lookahead)
+#define PREFETCH_BATCH_PAGES 16
+// Tandas que pueden esperar en la cola del hilo de prefetch; con la cola llena, las nuevas se descartan
+#define PREFETCH_QUEUE_MAX 32
+
+// Patrón de acceso de un proceso: última página accedida, salto entre las dos últimas páginas distintas,
+// cuántas veces seguidas se repitió ese salto, y la primera página que se sabe que está fuera del proceso (UINT32_MAX si no se sabe):
+typedef struct {
+    uint32_t pid;
+    uint32_t lastPage;
+    int32_t stride;
+    int confidence;
+    uint32_t endPage;
+    bool valid;
+} tPrefetchStream;
+
+// Prefetcher de la MMU: al detectar un acceso secuencial o de salto constante, trae las traducciones de las próximas distance páginas
+// a la TLB y, si pages está prendido, también su contenido a la Caché de Páginas.
+// Con lookahead, además, mira las próximas instrucciones ya decodificadas y adelanta las páginas de sus READ / WRITE (ver prefetch_lookahead).
+// Las trae el hilo de prefetch (ver mmuPrefetch.c): generation y writes le dicen si lo que trajo sigue valiendo cuando llega.
+// Los contadores de usados están en la TLB y en la Caché (prefetchesUsed); acá se cuentan los traídos por los dos caminos:
+typedef struct {
+    tPrefetchStream streams[PREFETCH_STREAMS];
+    int distance;
+    int lookahead;
+    bool pages;
+    uint64_t generation;
+    uint64_t writes;
+    uint64_t translationsIssued;
+    uint64_t pagesIssued;
+    uint64_t batches;
+    uint64_t lookaheadBatches;
+    uint64_t dropped;
+    uint64_t discarded;
+} tPrefetcher;
+
+void prefetch_init(int distance, int lookahead, bool pages);
+bool prefetch_start(void);
+void prefetch_invalidate(void);
+void prefetch_note_write(void);
+void prefetch_on_access(uint32_t pid, uint32_t page);
+void prefetch_lookahead(uint32_t pid, uint32_t pc);
+void prefetch_report(void);
+
+#endif
@@ -34,7 +34,7 @@ void* serverIoThreadForKernel(void* voidPointerConnectionSocket){
                 int duration = extractIntElementFromList(list, 1);
 
                 log_info(ioLog, "## PID: %d - Inicio de IO - Tiempo: %d", pid, duration);
-                sleep(duration);
+                simulatedSleepNs((uint64_t)duration * 1000000000ull);
                 log_info(ioLog, "## PID: %d - Fin de IO", pid);
                 break;
             }
@@ -13,6 +13,11 @@ t_list* cpus;
 sem_t semStates;
 sem_t semCpus;
 
+// Histogramas del planificador, se actualizan con semStates tomado: cuánto espera un proceso en READY hasta que se lo despacha a una CPU,
+// y cuánto dura cada ráfaga de CPU terminada (la real, la que alimenta la estimación de SJF/SRT):
+tLatencyHistogram dispatchLatency;
+tLatencyHistogram cpuBurstLength;
+
 // Inicializa el array de estados, en realidad lo que hace es crear las listas con list_create:
 void initializeStates(){
     sem_wait(&semStates);
@@ -207,8 +212,11 @@ void moveProcessFromListToAnother(int pid, enumStates originState, enumStates de
 
     list_add(states[destinyState], process);
 
-    process->MT[originState] += (milliseconds() - process->lastTimeState);
-    process->lastTimeState = milliseconds();
+    long long now = nanoseconds();
+    if (originState == READY && destinyState == EXEC)
+        histogram_record(&dispatchLatency, now - process->lastTimeState);
+    process->MT[originState] += (now - process->lastTimeState);
+    process->lastTimeState = now;
     process->ME[destinyState]++;
 
     char* originStateString = getStateString(originState);
@@ -242,6 +250,22 @@ char* getStateString(enumStates state){
     }
 }
 
+static void reportLatencyHistogram(const char* name, tLatencyHistogram* histogram){
+    if (histogram->count == 0)
+        return;
+    log_info(kernelLog, "%s: %lu muestras, media %.3f ms, p50 <= %.3f ms, p90 <= %.3f ms, p99 <= %.3f ms, máx %.3f ms", name,
+             (unsigned long)histogram->count, histogram_mean(histogram) / 1e6, histogram_percentile(histogram, 50) / 1e6,
+             histogram_percentile(histogram, 90) / 1e6, histogram_percentile(histogram, 99) / 1e6, histogram->maxNs / 1e6);
+}
+
+// Loguea los histogramas del planificador, al cerrar el Kernel:
+void reportSchedulingLatencies(){
+    sem_wait(&semStates);
+    reportLatencyHistogram("Latencia de despacho (READY -> EXEC)", &dispatchLatency);
+    reportLatencyHistogram("Duración de ráfagas de CPU", &cpuBurstLength);
+    sem_post(&semStates);
+}
+
 void sortReadyList(){
     if (list_size(states[READY]) > 1)
         list_sort(states[READY], hasSmallerRemainingEstimatedCpuBurst);
@@ -253,13 +277,15 @@ void updateCpuBurstTimesOfAll(){
 
 void updateCpuBurstTimes(void* voidProcess){
     tPcb* process = (tPcb*) voidProcess;
-    process->elapsedCurrentCpuBurst += milliseconds() - process->lastTimeBurst;
+    long long now = nanoseconds();
+    process->elapsedCurrentCpuBurst += now - process->lastTimeBurst;
     process->remainingEstimatedCpuBurst = process->estimatedCpuBurst - process->elapsedCurrentCpuBurst;
-    process->lastTimeBurst = milliseconds();
+    process->lastTimeBurst = now;
 }
 
 void calculateEstimatedCpuBurst(tPcb* process){
     updateCpuBurstTimes((void*) process);
+    histogram_record(&cpuBurstLength, process->elapsedCurrentCpuBurst);
 
     process->estimatedCpuBurst = kernelConfig->ALFA * process->elapsedCurrentCpuBurst + (1 - kernelConfig->ALFA) * process->estimatedCpuBurst;
     process->elapsedCurrentCpuBurst = 0;
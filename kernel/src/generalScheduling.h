@@ -4,6 +4,7 @@
 #include <commons/collections/list.h>
 #include <stdint.h>
 #include <semaphore.h>
+#include <histogram.h>
 
 // Enum que sirve para los índices de la lista states, para saber qué estado está en cada índice:
 typedef enum{
@@ -17,8 +18,9 @@ typedef enum{
 } enumStates;
 
 // Estructura del Proceso, que es el PCB, los primeros 4 elementos son los obligatorios, los otros son agregados por utilidad
-// El segundo grupo de elementos son el nombre del archivo de pseudocódigo, el tamaño del proceso en Memoria, y un flag que indica si el proceso está intentando ser cargado en Memoria (para no enviárselo a Memoria dos veces)
+// El segundo grupo de elementos son el nombre del archivo de pseudocódigo, el tamaño del proceso en Memoria, y un flag que indica si el proceso está intentando ser cargado en Memoria (para no enviárselo a Memoria dos veces), y el token de la reserva de espacio que le hizo Memoria (-1 si no tiene)
 // El tercer grupo son variables para utilizar en los algoritmos SJF y SRT, para estimar las ráfagas de CPU y medir cuánto les queda y lleva
+// Todos los tiempos (MT, las marcas lastTime y las ráfagas) están en nanosegundos de nanoseconds(); las métricas se loguean en milisegundos
 // El cuarto grupo son para saber información de si el proceso solicitó o no una IO, cuál, y cuánto tiempo pidió
 typedef struct{
     int pid;
@@ -32,6 +34,7 @@ typedef struct{
     char* pseudocodeFileName;
     uint32_t size;
     int attemptingEntryToMemory;
+    int memoryReservationToken;
     
     long long estimatedCpuBurst;
     long long remainingEstimatedCpuBurst;
@@ -73,6 +76,8 @@ void moveProcessFromListToAnother(int pid, enumStates originState, enumStates de
 
 char* getStateString(enumStates state);
 
+void reportSchedulingLatencies();
+
 void sortReadyList();
 void updateCpuBurstTimesOfAll();
 void updateCpuBurstTimes(void* voidProcess);
@@ -96,4 +101,7 @@ extern t_list* cpus;
 extern sem_t semStates;
 extern sem_t semCpus;
 
+extern tLatencyHistogram dispatchLatency;
+extern tLatencyHistogram cpuBurstLength;
+
 #endif
\ No newline at end of file
@@ -73,6 +73,7 @@ void* ioCompleted(void* voidIoAndInstanceParams){
     tIoAndInstanceParams* ioAndInstanceParams = (tIoAndInstanceParams*)voidIoAndInstanceParams;
     tIo* io = ioAndInstanceParams->io;
     tIoInstance* instance = ioAndInstanceParams->instance;
+    uint64_t completedAtNs = ioAndInstanceParams->completedAtNs;
     free(ioAndInstanceParams);
 
     enumStates processLocation = findProcessLocationByPid(instance->pidExecuting);
@@ -85,7 +86,7 @@ void* ioCompleted(void* voidIoAndInstanceParams){
     sendNewProcessToInstance(io, instance);
 
     // Se administra qué hacer con el proceso que estaba en la IO antes:
-    unblockProcess(process->pid, 1);
+    unblockProcess(process->pid, 1, completedAtNs);
 
     sem_post(&semIos);
     sem_post(&semCpus);
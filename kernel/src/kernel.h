@@ -18,6 +18,7 @@
 #include "generalScheduling.h"
 #include "longTermScheduling.h"
 #include "shortTermScheduling.h"
+#include "mediumTermScheduling.h"
 #include "interfaces.h"
 #include <server.h>
 #include <client.h>
@@ -37,6 +37,8 @@ void sendContextToCpu(int connectionSocket, int pid, int pc){
 
 void sendInterruptToCpu(tCpu* cpu){
     tPackage* interruptPackage = createPackage(KERNEL_TO_CPU_INTERRUPT_INTERRUPTION);
+    // Va el pid a desalojar, así la CPU no desaloja a otro proceso si la interrupción llega tarde
+    addToPackage(interruptPackage, &cpu->pidExecuting, sizeof(uint32_t));
     log_info(kernelLog, "A punto de enviar el paquete informando una interrupcion, desde Kernel a CPU");
 
     sendPackage(interruptPackage, cpu->connectionSocketInterrupt);
@@ -53,6 +55,7 @@ void sendRequestToLoadProcessToMemory(tPcb* process){
     addToPackage(loadProcessPackage, &process->pid, sizeof(uint32_t));
     addToPackage(loadProcessPackage, process->pseudocodeFileName, string_length(process->pseudocodeFileName) + 1);
     addToPackage(loadProcessPackage, &process->size, sizeof(uint32_t));
+    addToPackage(loadProcessPackage, &process->memoryReservationToken, sizeof(uint32_t));
 
     log_info(kernelLog, "A punto de enviar el paquete con el proceso a cargar a Memoria");
 
@@ -75,6 +78,39 @@ void sendRequestToLoadProcessToMemory(tPcb* process){
 
 
 
+// Función que le pide a Memoria, en un solo mensaje, que reserve espacio para varios procesos encolados.
+// Le envía si la reserva es estricta (FIFO: se corta en el primero que no entra), y luego pares [pid | tamaño]:
+void sendReservationRequestToMemory(t_list* processes, int strict){
+    int connectionSocketMemory = requestingConnectionSameThread(kernelLog, kernelConfig->IP_MEMORIA, kernelConfig->PUERTO_MEMORIA, handshakeFromKernelToMemoria);
+
+    tPackage* reservationPackage = createPackage(KERNEL_TO_MEMORY_RESERVE_SPACE);
+    addToPackage(reservationPackage, &strict, sizeof(uint32_t));
+
+    for (int i = 0; i < list_size(processes); i++){
+        tPcb* process = (tPcb*) list_get(processes, i);
+        addToPackage(reservationPackage, &process->pid, sizeof(uint32_t));
+        addToPackage(reservationPackage, &process->size, sizeof(uint32_t));
+    }
+
+    sendPackage(reservationPackage, connectionSocketMemory);
+
+    log_info(kernelLog, "Solicitud de reserva de espacio enviada a Memoria para %d procesos", list_size(processes));
+
+    serverForMemoria(connectionSocketMemory);
+}
+
+// Función que le avisa a Memoria que libere una reserva que ya no se va a usar, no espera respuesta:
+void sendReservationReleaseToMemory(int token){
+    int connectionSocketMemory = requestingConnectionSameThread(kernelLog, kernelConfig->IP_MEMORIA, kernelConfig->PUERTO_MEMORIA, handshakeFromKernelToMemoria);
+
+    tPackage* releasePackage = createPackage(KERNEL_TO_MEMORY_RELEASE_RESERVATION);
+    addToPackage(releasePackage, &token, sizeof(uint32_t));
+    sendPackage(releasePackage, connectionSocketMemory);
+    close(connectionSocketMemory);
+}
+
+
+
 // Función que envía a Memoria una solicitud de remover un proceso, le envía solo el PID del proceso.
 // La función recibe un pid, no un puntero al proceso:
 void sendRequestToRemoveProcessToMemory(int pid){
@@ -92,6 +128,20 @@ void sendRequestToRemoveProcessToMemory(int pid){
     serverForMemoria(connectionSocketMemory);
 }
 
+// Función que le pide a Memoria que baje un proceso a SWAP y libere sus marcos, le envía solo el PID del proceso:
+void sendRequestToSuspendProcessToMemory(int pid){
+    int connectionSocketMemory = requestingConnectionSameThread(kernelLog, kernelConfig->IP_MEMORIA, kernelConfig->PUERTO_MEMORIA, handshakeFromKernelToMemoria);
+
+    tPackage* suspendProcessPackage = createPackage(KERNEL_TO_MEMORY_REQUEST_TO_SUSPEND_PROCESS);
+    addToPackage(suspendProcessPackage, &pid, sizeof(uint32_t));
+
+    sendPackage(suspendProcessPackage, connectionSocketMemory);
+
+    log_info(kernelLog, "Solicitud de suspender proceso enviada a Memoria");
+
+    serverForMemoria(connectionSocketMemory);
+}
+
 // Función para solicitarle a Memoria que haga el Dump Memory de un proceso:
 void sendMemoryDumpRequest(int pid){
     int connectionSocketMemory = requestingConnectionSameThread(kernelLog, kernelConfig->IP_MEMORIA, kernelConfig->PUERTO_MEMORIA, handshakeFromKernelToMemoria);
@@ -12,8 +12,14 @@ void sendInterruptToCpu(tCpu* cpu);
 
 void sendRequestToLoadProcessToMemory(tPcb* process);
 
+void sendReservationRequestToMemory(t_list* processes, int strict);
+
+void sendReservationReleaseToMemory(int token);
+
 void sendRequestToRemoveProcessToMemory(int pid);
 
+void sendRequestToSuspendProcessToMemory(int pid);
+
 void sendMemoryDumpRequest(int pid);
 
 void sendIoUsageRequest(int connectionSocket, int pid, int usageTime);
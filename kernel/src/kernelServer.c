@@ -139,6 +139,15 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
                 pthread_create(&syscallExitThread, NULL, syscallExit, (void*)cpuIdPointer);
                 pthread_detach(syscallExitThread);
                 break;
+            case CPU_DISPATCH_TO_KERNEL_SEG_FAULT:
+                // El proceso terminó por un acceso inválido: se finaliza igual que con la syscall EXIT
+                log_error(kernelLog, "CPU %d: el proceso en ejecución terminó por SEGMENTATION FAULT.", cpuId);
+                pthread_t segFaultThread;
+                int* segFaultCpuIdPointer = malloc(sizeof(int));
+                *segFaultCpuIdPointer = cpuId;
+                pthread_create(&segFaultThread, NULL, syscallExit, (void*)segFaultCpuIdPointer);
+                pthread_detach(segFaultThread);
+                break;
             case CPU_DISPATCH_TO_KERNEL_IO:
                 pthread_t syscallIoThread;
                 listAndCpuParams = malloc(sizeof(tListAndCpuIdParams));
@@ -305,6 +314,7 @@ void* serverThreadForIo(void* voidPointerConnectionSocket){
                 ioAndInstanceParams = malloc(sizeof(tIoAndInstanceParams));
                 ioAndInstanceParams->io = io;
                 ioAndInstanceParams->instance = instance;
+                ioAndInstanceParams->completedAtNs = package->timestamp;
                 pthread_create(&ioCompletedThread, NULL, ioCompleted, (void*)ioAndInstanceParams);
                 pthread_detach(ioCompletedThread);
                 break;
@@ -386,6 +396,28 @@ void serverForMemoria(int connectionSocketMemory){
 
             removeProcess(list);
 
+            sem_post(&semIos);
+            sem_post(&semCpus);
+            sem_post(&semStates);
+            break;
+        case MEMORY_TO_KERNEL_RESERVATION_RESULT:
+            sem_wait(&semStates);
+            sem_wait(&semCpus);
+            sem_wait(&semIos);
+
+            applyReservationResult(list);
+
+            sem_post(&semIos);
+            sem_post(&semCpus);
+            sem_post(&semStates);
+            break;
+        case MEMORY_TO_KERNEL_PROCESS_SUSPENDED:
+            sem_wait(&semStates);
+            sem_wait(&semCpus);
+            sem_wait(&semIos);
+
+            processSuspended(list);
+
             sem_post(&semIos);
             sem_post(&semCpus);
             sem_post(&semStates);
@@ -395,7 +427,7 @@ void serverForMemoria(int connectionSocketMemory){
             sem_wait(&semCpus);
             sem_wait(&semIos);
 
-            dumpCompleted(list);
+            dumpCompleted(list, package->timestamp);
 
             sem_post(&semIos);
             sem_post(&semCpus);
@@ -1,6 +1,7 @@
 #ifndef KERNEL_SERVER_H
 #define KERNEL_SERVER_H
 
+#include <stdint.h>
 #include <commons/collections/list.h>
 #include "interfaces.h"
 
@@ -12,6 +13,7 @@ typedef struct{
 typedef struct{
     tIo* io;
     tIoInstance* instance;
+    uint64_t completedAtNs; // hora lógica del paquete de IO (ver mediumTermScheduling.c)
 } tIoAndInstanceParams;
 
 void* establishingKernelConnection(void* voidPointerConnectionSocket);
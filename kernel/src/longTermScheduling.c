@@ -27,7 +27,8 @@ tPcb* createNewProcess(char* pseudocodeFileName, int size){
     process->pseudocodeFileName = string_duplicate(pseudocodeFileName);
     process->size = size;
     process->attemptingEntryToMemory = 0;
-    process->estimatedCpuBurst = kernelConfig->ESTIMACION_INICIAL;
+    process->memoryReservationToken = -1;
+    process->estimatedCpuBurst = kernelConfig->ESTIMACION_INICIAL * 1000000LL;
     process->remainingEstimatedCpuBurst = process->estimatedCpuBurst;
     process->elapsedCurrentCpuBurst = 0LL;
 
@@ -56,7 +57,7 @@ void entryToNew(char* pseudocodeFileName, int size){
 
     list_add(states[NEW], process);
 
-    process->lastTimeState = milliseconds();
+    process->lastTimeState = nanoseconds();
     process->ME[NEW]++;
 
     log_info(kernelLog, "## (%d) Se crea el proceso - Estado: NEW", process->pid);
@@ -69,18 +70,115 @@ void entryToNew(char* pseudocodeFileName, int size){
 void decideIfSendRequestToLoadProcessToMemory(tPcb* process, enumStates state){
     if (string_equals_ignore_case(kernelConfig->ALGORITMO_INGRESO_A_READY, "FIFO")){
         if (list_size(states[state]) == 1){
-            // Se le pide a Memoria cargar el proceso
+            // Se le pide a Memoria reservar espacio y cargar el proceso
             if (!process->attemptingEntryToMemory)
-                sendRequestToLoadProcessToMemory(process);
+                reserveAndLoadProcesses(state);
         }
     }
     else{ // O sea, si el algoritmo es PMCP
-        // Se le pide a Memoria cargar el proceso
+        // Se le pide a Memoria reservar espacio y cargar el proceso
         if (!process->attemptingEntryToMemory)
-            sendRequestToLoadProcessToMemory(process);
+            reserveAndLoadProcesses(state);
     }
 }
 
+// Procesos en espera que todavía no pidieron reserva, y los que ya la tienen y se pueden mandar a cargar:
+static bool needsReservation(void* ptr){
+    tPcb* process = (tPcb*) ptr;
+    return !process->attemptingEntryToMemory && process->memoryReservationToken < 0;
+}
+
+static bool readyToLoad(void* ptr){
+    tPcb* process = (tPcb*) ptr;
+    return !process->attemptingEntryToMemory && process->memoryReservationToken >= 0;
+}
+
+// Se le pide a Memoria en un solo mensaje que reserve espacio para todos los procesos encolados en el estado que todavía no tienen reserva.
+// Con PMCP se piden ordenados de más chico a más grande, con FIFO se piden en orden de llegada y de forma estricta (Memoria corta en el primero que no entra):
+static void requestReservations(enumStates state){
+    int strict = string_equals_ignore_case(kernelConfig->ALGORITMO_INGRESO_A_READY, "FIFO");
+    t_list* pending = list_filter(states[state], needsReservation);
+
+    if (!list_is_empty(pending)){
+        if (strict)
+            sendReservationRequestToMemory(pending, strict);
+        else{
+            t_list* sortedPending = list_sorted(pending, hasSmallerSizeThan);
+            sendReservationRequestToMemory(sortedPending, strict);
+            list_destroy(sortedPending);
+        }
+    }
+    list_destroy(pending);
+}
+
+// Libera las reservas de los procesos de New que todavía no se mandaron a cargar, y retorna cuántas liberó:
+static int releaseNewReservations(void){
+    int released = 0;
+    for (int i = 0; i < list_size(states[NEW]); i++){
+        tPcb* process = (tPcb*) list_get(states[NEW], i);
+        if (readyToLoad(process)){
+            releaseMemoryReservation(process);
+            released++;
+        }
+    }
+    return released;
+}
+
+// Antes de mandar a cargar un proceso se reserva espacio para todos los encolados en el estado (ver requestReservations),
+// así se sabe de antemano cuáles entran sin tener que mandar un LOAD por cada uno y esperar el FAIL.
+// Después se manda a cargar el primer proceso que no esté intentando entrar y tenga reserva (el LOAD la usa); los demás conservan la suya
+// y se cargan cuando vuelva a tocarle a su estado. Suspended Ready tiene prioridad sobre New, así que si ningún suspendido consiguió reserva
+// se liberan las que tienen apartadas los procesos de New (que no se van a cargar mientras haya suspendidos esperando) y se reserva de nuevo.
+// Si aun así nadie entra, no se manda nada: se vuelve a intentar cuando se libere espacio (al finalizar o suspender un proceso):
+void reserveAndLoadProcesses(enumStates state){
+    requestReservations(state);
+    tPcb* process = list_find(states[state], readyToLoad);
+
+    if (!process && state == SUSPENDED_READY && releaseNewReservations() > 0){
+        log_info(kernelLog, "Ningún proceso de SUSPENDED_READY entró en Memoria, se liberaron las reservas de NEW y se reserva de nuevo");
+        requestReservations(state);
+        process = list_find(states[state], readyToLoad);
+    }
+
+    if (process)
+        sendRequestToLoadProcessToMemory(process);
+}
+
+// Libera en Memoria la reserva que tenga el proceso, si es que no la va a usar (por ejemplo, si se elimina sin haberse cargado):
+void releaseMemoryReservation(tPcb* process){
+    if (process->memoryReservationToken < 0)
+        return;
+    sendReservationReleaseToMemory(process->memoryReservationToken);
+    process->memoryReservationToken = -1;
+}
+
+// Guarda en cada proceso el token de reserva que le devolvió Memoria (-1 si no había espacio para él).
+// La lista tiene primero el espacio libre que le queda a Memoria, y luego pares [pid | token]:
+void applyReservationResult(t_list* list){
+    int freeSpace = extractIntElementFromList(list, 0);
+    int reserved = 0;
+
+    for (int i = 1; i + 1 < list_size(list); i += 2){
+        int pid = extractIntElementFromList(list, i);
+        int token = extractIntElementFromList(list, i + 1);
+
+        // El proceso pudo haber cambiado de estado mientras se esperaba la respuesta, por eso se busca solo en los estados de espera:
+        tPcb* process = findProcessByPid(pid, NEW);
+        if (!process)
+            process = findProcessByPid(pid, SUSPENDED_READY);
+
+        if (process && !process->attemptingEntryToMemory)
+            process->memoryReservationToken = token;
+        else if (token >= 0)
+            sendReservationReleaseToMemory(token);
+
+        if (token >= 0)
+            reserved++;
+    }
+
+    log_info(kernelLog, "Memoria reservó espacio para %d de %d procesos, le quedan %d bytes libres", reserved, (list_size(list) - 1) / 2, freeSpace);
+}
+
 // Mueve el proceso que Memoria informó que se cargó correctamente a Memoria, al estado de Ready en el planificador:
 void moveProcessToReady(t_list* list){
     int pid = extractIntElementFromList(list, 0);
@@ -89,8 +187,9 @@ void moveProcessToReady(t_list* list){
     enumStates processLocation = findProcessLocationByPid(pid);
     tPcb* process = findProcessByPid(pid, processLocation);
 
-    // Se setea el flag de que estaba intentando entrar a Memoria en 0 (porque ya entró a Memoria):
+    // Se setea el flag de que estaba intentando entrar a Memoria en 0 (porque ya entró a Memoria), y la reserva ya se consumió:
     process->attemptingEntryToMemory = 0;
+    process->memoryReservationToken = -1;
 
     // Se mueve el proceso de donde estaba (New o Suspended Ready) a Ready:
     if (processLocation == NEW)
@@ -112,25 +211,28 @@ void tryToLoadMoreProcessesToMemory(){
         // Asumo que la lista está ordenada (debería estar ordenada) y envío el primer proceso de Suspended Ready con el flag attemptingEntryToMemory en 0 a que se cargue a Memoria:
         process = findFirstProcessWithFlag0(SUSPENDED_READY);
         if (process)
-            sendRequestToLoadProcessToMemory(process);
+            reserveAndLoadProcesses(SUSPENDED_READY);
     }
     // Si no hay procesos en Suspended Ready, intento hacer lo mismo pero con New:
     else if (!list_is_empty(states[NEW])){
         // Asumo que la lista está ordenada (debería estar ordenada) y envío el primer proceso de New con el flag attemptingEntryToMemory en 0 a que se cargue a Memoria:
         process = findFirstProcessWithFlag0(NEW);
         if (process)
-            sendRequestToLoadProcessToMemory(process);
+            reserveAndLoadProcesses(NEW);
     }
 }
 
 // Si el algoritmo de ingreso a ready es PMCP, se ordena la lista segun ese criterio
-// (si es FIFO no es necesario porque siempre están encolados en orden de llegada):
+// (si es FIFO no es necesario porque siempre están encolados en orden de llegada).
+// Si la carga falló, Memoria ya liberó la reserva que tuviera el proceso, así que se le borra el token:
 void sortPmcpList(t_list* list){
-    if (string_equals_ignore_case(kernelConfig->ALGORITMO_INGRESO_A_READY, "PMCP")){
-        int pid = extractIntElementFromList(list, 0);
+    int pid = extractIntElementFromList(list, 0);
+
+    enumStates processLocation = findProcessLocationByPid(pid);
+    tPcb* process = findProcessByPid(pid, processLocation);
+    process->memoryReservationToken = -1;
 
-        enumStates processLocation = findProcessLocationByPid(pid);
-        tPcb* process = findProcessByPid(pid, processLocation);
+    if (string_equals_ignore_case(kernelConfig->ALGORITMO_INGRESO_A_READY, "PMCP")){
         process->attemptingEntryToMemory = 0;
 
         if (list_size(states[processLocation]) > 1)
@@ -151,6 +253,10 @@ void removeProcess(t_list* list){
 
     int pid = extractIntElementFromList(list, 0);
 
+    // Memoria contesta recién cuando las CPUs conectadas invalidaron lo que tenían del proceso (TLB shootdown), y manda cuántas confirmaron:
+    if (list_size(list) > 1)
+        log_info(kernelLog, "## (<%d>) - TLB shootdown confirmado por %d CPUs", pid, extractIntElementFromList(list, 1));
+
     enumStates processLocation = findProcessLocationByPid(pid);
     if (processLocation != EXIT){
         log_info(kernelLog, "El proceso a remover no estaba en la cola de Exit, esto no debería pasar. Cerrando programa.");
@@ -159,11 +265,13 @@ void removeProcess(t_list* list){
     tPcb* process = findProcessByPid(pid, EXIT);
     list_remove_element(states[EXIT], process);
 
-    process->MT[EXIT] += (milliseconds() - process->lastTimeState);
+    process->MT[EXIT] += (nanoseconds() - process->lastTimeState);
 
     log_info(kernelLog, "## (<%d>) - Finaliza el proceso", pid);
 
-    log_info(kernelLog, "<%d> - Métricas de estado: NEW (%d) (%lld), READY (%d) (%lld), EXEC (%d) (%lld), BLOCKED (%d) (%lld), SUSPENDED_BLOCKED (%d) (%lld), SUSPENDED_READY (%d) (%lld), EXIT (%d) (%lld)", pid, process->ME[0], process->MT[0], process->ME[1], process->MT[1], process->ME[2], process->MT[2], process->ME[3], process->MT[3], process->ME[4], process->MT[4], process->ME[5], process->MT[5], process->ME[6], process->MT[6]);
+    releaseMemoryReservation(process);
+
+    log_info(kernelLog, "<%d> - Métricas de estado: NEW (%d) (%lld), READY (%d) (%lld), EXEC (%d) (%lld), BLOCKED (%d) (%lld), SUSPENDED_BLOCKED (%d) (%lld), SUSPENDED_READY (%d) (%lld), EXIT (%d) (%lld)", pid, process->ME[0], process->MT[0] / 1000000, process->ME[1], process->MT[1] / 1000000, process->ME[2], process->MT[2] / 1000000, process->ME[3], process->MT[3] / 1000000, process->ME[4], process->MT[4] / 1000000, process->ME[5], process->MT[5] / 1000000, process->ME[6], process->MT[6] / 1000000);
 
     destroyProcess(process);
 
@@ -185,9 +293,6 @@ void moveBlockedProcessToExit(int pid){
 
     moveProcessFromListToAnother(pid, processLocation, EXIT);
 
-    if (processLocation == BLOCKED)
-        sendRequestToRemoveProcessToMemory(pid);
-    //else
-        // PARTE DEL PLANIFICADOR DE MEDIANO PLAZO:
-        // SI EL PROCESO ESTABA EN SUSPENDED_BLOCKED SE LE DEBERÍA PEDIR A MEMORIA QUE BORRE LA ENTRADA DE SWAP DEL PROCESO
+    // Si estaba suspendido, Memoria borra lo que tenga del proceso en SWAP en vez de liberar sus marcos:
+    sendRequestToRemoveProcessToMemory(pid);
 }
\ No newline at end of file
@@ -11,6 +11,12 @@ void entryToNew(char* pseudocodeFileName, int size);
 
 void decideIfSendRequestToLoadProcessToMemory(tPcb* process, enumStates state);
 
+void reserveAndLoadProcesses(enumStates state);
+
+void releaseMemoryReservation(tPcb* process);
+
+void applyReservationResult(t_list* list);
+
 void moveProcessToReady(t_list* list);
 
 void tryToLoadMoreProcessesToMemory();
@@ -69,6 +69,7 @@ int main(int argc, char* argv[]){
 
     // Se pide que se ingrese un caracter para que no termine abruptamente, luego se da la señal de finalizar servidor, se cierran los sockets de escucha y se destruyen el logger y config:
     getchar();
+    reportSchedulingLatencies();
     finishServer = 1;
     close(listeningSocketDispatch);
     close(listeningSocketInterrupt);
@@ -0,0 +1,92 @@
+#include "mediumTermScheduling.h"
+#include "kernel.h"
+
+// Planificador de mediano plazo: cuando un proceso entra a BLOCKED se arranca un timer de TIEMPO_SUSPENSION milisegundos.
+// Si al vencer el proceso sigue en el mismo bloqueo (no se desbloqueó y se volvió a bloquear en el medio), se lo pasa a SUSPENDED_BLOCKED
+// y se le pide a Memoria que lo baje a SWAP. Mientras Memoria lo baja, el proceso queda con el flag attemptingEntryToMemory en 1,
+// así no se manda un LOAD suyo antes de que termine el SUSPEND; con la respuesta se intenta cargar otro proceso en el espacio liberado.
+// Con TIEMPO_LOGICO no se arma el timer: dormir solo adelanta el reloj, así que vencería apenas se lo pide. La suspensión se decide
+// al desbloquearse, comparando la hora lógica en que el proceso entró a BLOCKED con la del paquete que avisó el fin del IO o del dump.
+// El resultado no depende del orden en que corren los hilos, pero el proceso recién se baja a SWAP al desbloquearse: mientras tanto
+// sigue ocupando su memoria, y un proceso que la esperaba no la recibe antes.
+
+static void suspendProcess(tPcb* process){
+    moveProcessFromListToAnother(process->pid, BLOCKED, SUSPENDED_BLOCKED);
+    releaseMemoryReservation(process);
+    process->attemptingEntryToMemory = 1;
+    sendRequestToSuspendProcessToMemory(process->pid);
+}
+
+typedef struct{
+    int pid;
+    int blockedEntries; // ME[BLOCKED] al bloquearse, identifica el bloqueo que armó el timer
+} tSuspensionTimer;
+
+static void* suspensionTimer(void* voidTimer){
+    tSuspensionTimer* timer = (tSuspensionTimer*)voidTimer;
+    simulatedSleepMs(kernelConfig->TIEMPO_SUSPENSION);
+
+    sem_wait(&semStates);
+    sem_wait(&semCpus);
+    sem_wait(&semIos);
+
+    tPcb* process = findProcessByPid(timer->pid, BLOCKED);
+    if (process && process->ME[BLOCKED] == timer->blockedEntries)
+        suspendProcess(process);
+
+    sem_post(&semIos);
+    sem_post(&semCpus);
+    sem_post(&semStates);
+
+    free(timer);
+    return NULL;
+}
+
+// Se llama con el proceso recién movido a BLOCKED:
+void startSuspensionTimer(tPcb* process){
+    if (logicalClockEnabled())
+        return;
+
+    tSuspensionTimer* timer = malloc(sizeof(tSuspensionTimer));
+    timer->pid = process->pid;
+    timer->blockedEntries = process->ME[BLOCKED];
+
+    pthread_t suspensionTimerThread;
+    pthread_create(&suspensionTimerThread, NULL, suspensionTimer, (void*)timer);
+    pthread_detach(suspensionTimerThread);
+}
+
+// Tiempo lógico: se llama al terminar el IO o el dump de un proceso que sigue en BLOCKED. lastTimeState tiene la hora lógica en que
+// entró a BLOCKED; si hasta completedAtNs pasó TIEMPO_SUSPENSION o más, el timer habría vencido antes, así que se lo suspende ahora.
+// Retorna true si lo suspendió (en tiempo real siempre false: de eso se encarga el timer):
+bool suspendIfBlockedSince(tPcb* process, uint64_t completedAtNs){
+    if (!logicalClockEnabled())
+        return false;
+
+    uint64_t suspensionNs = (uint64_t)kernelConfig->TIEMPO_SUSPENSION * 1000000ull;
+    if (completedAtNs < (uint64_t)process->lastTimeState + suspensionNs)
+        return false;
+
+    log_info(kernelLog, "## (<%d>) - Estuvo bloqueado %llu ms de tiempo lógico: se suspende antes de desbloquearlo", process->pid,
+             (unsigned long long)((completedAtNs - process->lastTimeState) / 1000000));
+    suspendProcess(process);
+    return true;
+}
+
+// Memoria terminó de bajar el proceso a SWAP (la lista trae el pid y cuántas CPUs confirmaron el shootdown).
+// El proceso puede estar todavía en SUSPENDED_BLOCKED, o ya en SUSPENDED_READY si terminó su IO mientras tanto:
+void processSuspended(t_list* list){
+    int pid = extractIntElementFromList(list, 0);
+    int confirmedCpus = list_size(list) > 1 ? extractIntElementFromList(list, 1) : 0;
+
+    tPcb* process = findProcessByPid(pid, SUSPENDED_BLOCKED);
+    if (!process)
+        process = findProcessByPid(pid, SUSPENDED_READY);
+    if (process)
+        process->attemptingEntryToMemory = 0;
+
+    log_info(kernelLog, "## (<%d>) - Memoria bajó el proceso a SWAP (TLB shootdown confirmado por %d CPUs)", pid, confirmedCpus);
+
+    // Se intenta cargar otro proceso (o este mismo, si ya está en SUSPENDED_READY) con el espacio que quedó libre:
+    tryToLoadMoreProcessesToMemory();
+}
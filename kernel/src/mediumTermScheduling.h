@@ -0,0 +1,12 @@
+#ifndef MEDIUM_TERM_SCHEDULING_H
+#define MEDIUM_TERM_SCHEDULING_H
+
+#include <commons/collections/list.h>
+#include "generalScheduling.h"
+
+void startSuspensionTimer(tPcb* process);
+bool suspendIfBlockedSince(tPcb* process, uint64_t completedAtNs);
+
+void processSuspended(t_list* list);
+
+#endif
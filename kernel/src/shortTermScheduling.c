@@ -73,8 +73,6 @@ void* syscallIo(void* voidListAndCpuParams){
         blockProcess(pid, 1, ioDevice);
         calculateEstimatedCpuBurst(process);
 
-        // En el planificador de mediano plazo acá se debería iniciar algun timer que de una notificacion para moverlo a SUSPENDED BLOCKED
-        
         // Se busca una instancia libre en la I/O que pidió el proceso:
         tIoInstance* instance = findFreeInstanceByIo(io);
         if (instance)
@@ -159,8 +157,6 @@ void* syscallDumpMemory(void* voidListAndCpuParams){
     cpu->isExecuting = 0;
     cpu->pidExecuting = -1;
 
-    // iniciar algun temporizador en el planificador de mediano plazo
-
     // Se llama a la función que intenta meter otro proceso de READY al procesador que acaba de quedar libre:
     sendSomeProcessToExec(cpu);
 
@@ -175,11 +171,11 @@ void* syscallDumpMemory(void* voidListAndCpuParams){
     return NULL;
 }
 
-void dumpCompleted(t_list* list){
+void dumpCompleted(t_list* list, uint64_t completedAtNs){
     int pid = extractIntElementFromList(list, 0);
 
     // Se administra que pasa con el proceso al desbloquearse:
-    unblockProcess(pid, 0);
+    unblockProcess(pid, 0, completedAtNs);
 }
 
 // Función que administra un cpu que confirmó su desalojo, lo marca como libre, y pasa el proceso que tenía a READY, ordenando la lista de READY,
@@ -218,20 +214,28 @@ void* preemptionCompleted(void* voidListAndCpuParams){
     return NULL;
 }
 
+// Mueve el proceso de EXEC a BLOCKED y arranca el timer del planificador de mediano plazo que lo suspende si sigue bloqueado:
 void blockProcess(int pid, int becauseOfIo, char* device){
     moveProcessFromListToAnother(pid, EXEC, BLOCKED);
     if (becauseOfIo)
         log_info(kernelLog, "## (<%d>) - Bloqueado por IO: %s", pid, device);
     else
         log_info(kernelLog, "## (<%d>) - Bloqueado por DUMP MEMORY", pid);
+
+    startSuspensionTimer(findProcessByPid(pid, BLOCKED));
 }
 
 // Función que desbloquea un proceso, sea que estuviera en BLOCKED o en SUSPENDED_BLOCKED,
-// también llama a otras funciones que deciden qué hacer dependiendo si el proceso se movió a READY o a SUSPENDED_READY:
-void unblockProcess(int pid, int becauseOfIo){
+// también llama a otras funciones que deciden qué hacer dependiendo si el proceso se movió a READY o a SUSPENDED_READY.
+// completedAtNs es la hora lógica del paquete que avisó el fin del IO o del dump (0 en tiempo real):
+void unblockProcess(int pid, int becauseOfIo, uint64_t completedAtNs){
     enumStates processLocation = findProcessLocationByPid(pid);
     tPcb* process = findProcessByPid(pid, processLocation);
 
+    // En tiempo lógico no hay timer de suspensión: se decide acá si el proceso llegó a suspenderse (ver mediumTermScheduling.c)
+    if (processLocation == BLOCKED && suspendIfBlockedSince(process, completedAtNs))
+        processLocation = findProcessLocationByPid(pid);
+
     // Se administra qué hacer con el proceso:
     if (processLocation == BLOCKED){
         // Si estaba en BLOCKED se lo mueve a READY y se ejecuta la función que administra que pasa cuando un proceso entra a READY:
@@ -286,6 +290,6 @@ void sendSomeProcessToExec(tCpu* cpu){
         cpu->pidExecuting = process->pid;
         cpu->isExecuting = 1;
 
-        process->lastTimeBurst = milliseconds();
+        process->lastTimeBurst = nanoseconds();
     }
 }
\ No newline at end of file
@@ -9,11 +9,11 @@ void* syscallIo(void* voidListAndCpuParams);
 void* syscallInitProc(void* voidListAndCpuParams);
 void* syscallDumpMemory(void* voidListAndCpuParams);
 
-void dumpCompleted(t_list* list);
+void dumpCompleted(t_list* list, uint64_t completedAtNs);
 void* preemptionCompleted(void* voidListAndCpuParams);
 
 void blockProcess(int pid, int becauseOfIo, char* device);
-void unblockProcess(int pid, int becauseOfIo);
+void unblockProcess(int pid, int becauseOfIo, uint64_t completedAtNs);
 void entryToReady(tPcb* process);
 void sendSomeProcessToExec(tCpu* cpu);
 
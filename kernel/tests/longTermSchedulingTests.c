@@ -0,0 +1,216 @@
+#include "kernel.h"
+// cspec.h va después: define la macro end, que choca con un campo de readline.h
+#include <cspecs/cspec.h>
+
+// Memoria de prueba para la admisión: atiende de a una las conexiones efímeras del Kernel (handshake y un pedido),
+// con el espacio libre en bytes y las reservas por token, igual que la Memoria real pero sin marcos ni procesos:
+#define FAKE_MEMORIA_PORT "18002"
+#define FAKE_MEMORIA_BYTES 1000
+
+typedef struct {
+    int token;
+    int size;
+} tFakeReservation;
+
+static int fakeFreeBytes;
+static int fakeNextToken;
+static t_list* fakeReservations;
+static int fakeListeningSocket = -1;
+static kernelConfigStruct testConfig;
+
+static int fakeReserve(int size){
+    if (size > fakeFreeBytes)
+        return -1;
+    tFakeReservation* reservation = malloc(sizeof(tFakeReservation));
+    reservation->token = fakeNextToken++;
+    reservation->size = size;
+    list_add(fakeReservations, reservation);
+    fakeFreeBytes -= size;
+    return reservation->token;
+}
+
+// Saca la reserva del token y retorna su tamaño, o -1 si no existe:
+static int fakeTakeReservation(int token){
+    for (int i = 0; i < list_size(fakeReservations); i++){
+        tFakeReservation* reservation = list_get(fakeReservations, i);
+        if (reservation->token == token){
+            int size = reservation->size;
+            free(list_remove(fakeReservations, i));
+            return size;
+        }
+    }
+    return -1;
+}
+
+static void fakeServe(int connectionSocket, tOperationCode operationCode, t_list* list){
+    switch (operationCode){
+        case KERNEL_TO_MEMORY_RESERVE_SPACE: {
+            int strict = extractIntElementFromList(list, 0);
+            int requests = (list_size(list) - 1) / 2;
+            int pids[requests > 0 ? requests : 1];
+            int tokens[requests > 0 ? requests : 1];
+            int rejected = 0;
+            for (int i = 0; i < requests; i++){
+                pids[i] = extractIntElementFromList(list, 1 + 2 * i);
+                tokens[i] = (strict && rejected) ? -1 : fakeReserve(extractIntElementFromList(list, 2 + 2 * i));
+                if (tokens[i] < 0)
+                    rejected = 1;
+            }
+
+            tPackage* response = createPackage(MEMORY_TO_KERNEL_RESERVATION_RESULT);
+            addToPackage(response, &fakeFreeBytes, sizeof(int));
+            for (int i = 0; i < requests; i++){
+                addToPackage(response, &pids[i], sizeof(int));
+                addToPackage(response, &tokens[i], sizeof(int));
+            }
+            sendPackage(response, connectionSocket);
+            break;
+        }
+        case KERNEL_TO_MEMORY_REQUEST_TO_LOAD_PROCESS: {
+            int pid = extractIntElementFromList(list, 0);
+            int size = extractIntElementFromList(list, 2);
+            int token = extractIntElementFromList(list, 3);
+
+            // Con reserva, el espacio ya estaba descontado; sin reserva, se carga solo si entra:
+            bool loaded = token >= 0 && fakeTakeReservation(token) >= 0;
+            if (!loaded && size <= fakeFreeBytes){
+                fakeFreeBytes -= size;
+                loaded = true;
+            }
+
+            tPackage* response = createPackage(loaded ? MEMORY_TO_KERNEL_PROCESS_LOAD_OK : MEMORY_TO_KERNEL_PROCESS_LOAD_FAIL);
+            addToPackage(response, &pid, sizeof(uint32_t));
+            sendPackage(response, connectionSocket);
+            break;
+        }
+        case KERNEL_TO_MEMORY_RELEASE_RESERVATION: {
+            int size = fakeTakeReservation(extractIntElementFromList(list, 0));
+            if (size >= 0)
+                fakeFreeBytes += size;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void* fakeMemoria(void* unused){
+    while (1){
+        int connectionSocket = accept(fakeListeningSocket, NULL, NULL);
+        if (connectionSocket < 0)
+            return NULL;
+
+        tPackage* handshake = receivePackage(connectionSocket);
+        if (handshake){
+            destroyPackage(handshake);
+            sendPackage(createPackage(MEMORIA_OK), connectionSocket);
+
+            tPackage* request = receivePackage(connectionSocket);
+            if (request){
+                t_list* list = packageToList(request);
+                fakeServe(connectionSocket, request->operationCode, list);
+                list_destroy_and_destroy_elements(list, free);
+                destroyPackage(request);
+            }
+        }
+        close(connectionSocket);
+    }
+}
+
+// Levanta una sola vez el Kernel mínimo (logger, config, estados, semáforos) y la Memoria de prueba, y en cada caso vacía los estados y la Memoria:
+static void resetAdmission(void){
+    if (fakeListeningSocket == -1){
+        kernelLog = log_create("kernel_tests.log", "KERNEL_TESTS", false, LOG_LEVEL_INFO);
+        testConfig.IP_MEMORIA = "127.0.0.1";
+        testConfig.PUERTO_MEMORIA = FAKE_MEMORIA_PORT;
+        testConfig.ALGORITMO_CORTO_PLAZO = "FIFO";
+        testConfig.ALGORITMO_INGRESO_A_READY = "PMCP";
+        testConfig.ESTIMACION_INICIAL = 10000;
+        kernelConfig = &testConfig;
+
+        sem_init(&semStates, 0, 1);
+        sem_init(&semCpus, 0, 1);
+        sem_init(&semIos, 0, 1);
+        initializeStates();
+        initializeCpus();
+
+        fakeReservations = list_create();
+        fakeListeningSocket = createListeningSocket(kernelLog, FAKE_MEMORIA_PORT);
+        pthread_t thread;
+        pthread_create(&thread, NULL, fakeMemoria, NULL);
+        pthread_detach(thread);
+    }
+
+    for (int i = 0; i < 7; i++)
+        list_clean_and_destroy_elements(states[i], (void*)destroyProcess);
+    list_clean_and_destroy_elements(fakeReservations, free);
+    fakeFreeBytes = FAKE_MEMORIA_BYTES;
+    fakeNextToken = 0;
+}
+
+// Encola un proceso en un estado de espera sin pedir nada a Memoria (como si hubiera llegado mientras se esperaba otra respuesta):
+static tPcb* addWaitingProcess(enumStates state, int size){
+    tPcb* process = createNewProcess("pseudocodigo", size);
+    list_add(states[state], process);
+    return process;
+}
+
+static void lockScheduling(void){
+    sem_wait(&semStates);
+    sem_wait(&semCpus);
+    sem_wait(&semIos);
+}
+
+static void unlockScheduling(void){
+    sem_post(&semIos);
+    sem_post(&semCpus);
+    sem_post(&semStates);
+}
+
+context (longTermScheduling) {
+    describe ("Admisión con reservas de Memoria (PMCP)") {
+        it ("un proceso de SUSPENDED_READY que solo entra en los marcos reservados por NEW los recupera y se carga") {
+            resetAdmission();
+            int n1 = addWaitingProcess(NEW, 300)->pid;
+            int n2 = addWaitingProcess(NEW, 300)->pid;
+            int n3 = addWaitingProcess(NEW, 300)->pid;
+
+            // Los tres de NEW consiguen reserva, pero mientras se espera su LOAD se suspende otro proceso que vuelve a SUSPENDED_READY:
+            lockScheduling();
+            sendReservationRequestToMemory(states[NEW], 0);
+            should_int(fakeFreeBytes) be equal to(100);
+            int suspended = addWaitingProcess(SUSPENDED_READY, 500)->pid;
+            tryToLoadMoreProcessesToMemory();
+            unlockScheduling();
+
+            should_int(findProcessLocationByPid(suspended)) be equal to(READY);
+            should_int(findProcessLocationByPid(n1)) be equal to(READY);
+            should_int(findProcessLocationByPid(n2)) be equal to(NEW);
+            should_int(findProcessLocationByPid(n3)) be equal to(NEW);
+            should_int(findProcessByPid(n2, NEW)->memoryReservationToken) be equal to(-1);
+            should_int(findProcessByPid(n3, NEW)->memoryReservationToken) be equal to(-1);
+            should_int(list_size(fakeReservations)) be equal to(0);
+            should_int(fakeFreeBytes) be equal to(200);
+        } end
+
+        it ("si el proceso de SUSPENDED_READY entra sin tocar las reservas de NEW, después se cargan los de NEW con la suya") {
+            resetAdmission();
+            int n1 = addWaitingProcess(NEW, 300)->pid;
+            int n2 = addWaitingProcess(NEW, 300)->pid;
+            int n3 = addWaitingProcess(NEW, 300)->pid;
+
+            lockScheduling();
+            sendReservationRequestToMemory(states[NEW], 0);
+            int suspended = addWaitingProcess(SUSPENDED_READY, 100)->pid;
+            tryToLoadMoreProcessesToMemory();
+            unlockScheduling();
+
+            should_int(findProcessLocationByPid(suspended)) be equal to(READY);
+            should_int(findProcessLocationByPid(n1)) be equal to(READY);
+            should_int(findProcessLocationByPid(n2)) be equal to(READY);
+            should_int(findProcessLocationByPid(n3)) be equal to(READY);
+            should_int(list_size(fakeReservations)) be equal to(0);
+            should_int(fakeFreeBytes) be equal to(0);
+        } end
+    } end
+}
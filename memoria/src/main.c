@@ -3,7 +3,42 @@
 
 
 
+// Destructor de los procesos del diccionario de procesos cargados, para la limpieza al terminar:
+static void destroyActiveProcess(void* proc) {
+    destroyMemoriaProcess(proc);
+}
+
 int main(int argc, char* argv[]){
+    // Modo herramienta: rearma la imagen completa de un proceso a partir de su dump base y sus deltas, sin levantar el servidor
+    // Uso: ./bin/memoria --rebuild-dump <base.dmp> [<delta>...] <salida>
+    if (argc >= 4 && strcmp(argv[1], "--rebuild-dump") == 0) {
+        memoriaLog = logCreate("MEMORIA_DUMP");
+        int ok = rebuildDumpImage(argv[2], &argv[3], argc - 4, argv[argc - 1]);
+        logDestroy(memoriaLog);
+        return ok ? 0 : 1;
+    }
+
+    // Modo benchmark: crea y destruye procesos en un ciclo midiendo el RSS, sin levantar el servidor
+    // Uso: ./bin/memoria --soak <ciclos> <pseudocódigo> <tamaño>
+    if (argc == 5 && strcmp(argv[1], "--soak") == 0) {
+        // El logger de Memoria solo muestra errores, si no los logs de cada proceso taparían los del benchmark
+        memoriaLog = log_create("MEMORIA.log", "MEMORIA", false, LOG_LEVEL_WARNING);
+        memoriaConfigInitialize();
+        initMemory();
+        initSwap();
+        initReservations();
+        int result = runSoakBenchmark(atol(argv[2]), argv[3], atoi(argv[4]));
+        destroyReservations();
+        destroySwap();
+        free(frameBitmap->bitarray);
+        bitarray_destroy(frameBitmap);
+        free(framePages);
+        free(memory);
+        log_destroy(memoriaLog);
+        configDestroy(memoriaConfigFile, memoriaConfig);
+        return result;
+    }
+
     // Se setea la señal de finalizar servidor en 0 (falso):
     finishServer = 0;
     // Se crean e inicializan el logger y config:
@@ -16,8 +51,14 @@ int main(int argc, char* argv[]){
     // Crea bitmap de frames
     // (En memoriaServer.c) define createProcess() para usar bitmap
     initMemory();
+    // Crea el tier comprimido y el archivo de SWAP
+    initSwap();
+    // Lista de reservas de espacio pedidas por el Kernel
+    initReservations();
     // Crear diccionario PID→t_memoriaProcess*  // se usa DICT para luego buscar por PID
     activeProcesses = dictionary_create();
+    // Export periódico de métricas (si STATS_INTERVALO > 0)
+    startStatsExporter();
 
     // La Memoria crea 1 hilo para escuchar conexiones, todos en el mismo puerto (PUERTO_ESCUCHA) asumo que es porque igualmente sus conexiones deben ser efímeras:
     createThreadForListeningConnections(memoriaLog, getMemoriaConfig()->PUERTO_ESCUCHA, &finishServer, &listeningSocket, &establishingMemoriaConnection);
@@ -28,11 +69,18 @@ int main(int argc, char* argv[]){
     close(listeningSocket);
     usleep(2000000);
 
+    stopStatsExporter();
+
     // Limpieza de recursos Diccionario de procesos cargados
-    dictionary_destroy_and_destroy_elements(activeProcesses, free);
+    dictionary_destroy_and_destroy_elements(activeProcesses, destroyActiveProcess);
     
+    destroyReservations();
+    destroySwap();
+
     // Bitmap y RAM (asumimos que initMemory guardó el buffer)
+    free(frameBitmap->bitarray);
     bitarray_destroy(frameBitmap);
+    free(framePages);
     free(memory);
 
 
@@ -14,6 +14,12 @@
 #include "memoriaConfig.h"
 #include "memoriaClient.h"
 #include "memoriaServer.h"
+#include "memoriaSwap.h"
+#include "memoriaDump.h"
+#include "memoriaReservation.h"
+#include "memoriaArena.h"
+#include "memoriaSoak.h"
+#include "memoriaShootdown.h"
 #include <server.h>
 #include <client.h>
 #include <generalConnections.h>
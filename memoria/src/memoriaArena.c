@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+#include "memoriaArena.h"
+
+#define ARENA_MIN_BLOCK 4096
+
+// Los bloques salen de malloc, que alinea a alignof(max_align_t): con data en un offset múltiplo de ARENA_ALIGNMENT alcanza
+_Static_assert(alignof(max_align_t) >= ARENA_ALIGNMENT, "malloc no garantiza ARENA_ALIGNMENT");
+_Static_assert(offsetof(t_arenaBlock, data) % ARENA_ALIGNMENT == 0, "data del bloque no queda alineado");
+
+static size_t alignUp(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static t_arenaBlock* newBlock(size_t size) {
+    t_arenaBlock* block = malloc(sizeof(t_arenaBlock) + size);
+    if (!block)
+        abort();
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+// Crea la arena con un primer bloque de expectedBytes (o más, si es muy chico):
+t_memoriaArena* arenaCreate(size_t expectedBytes) {
+    t_memoriaArena* arena = malloc(sizeof(t_memoriaArena));
+    if (!arena)
+        abort();
+    arena->blockSize = alignUp(expectedBytes > ARENA_MIN_BLOCK ? expectedBytes : ARENA_MIN_BLOCK);
+    arena->blocks = newBlock(arena->blockSize);
+    arena->totalBytes = arena->blockSize;
+    return arena;
+}
+
+// Devuelve size bytes en 0 alineados a ARENA_ALIGNMENT. Si no entran en el bloque actual se encadena otro
+// (del doble del tamaño de bloque, o del tamaño pedido si es más grande):
+void* arenaAlloc(t_memoriaArena* arena, size_t size) {
+    size = alignUp(size > 0 ? size : 1);
+    t_arenaBlock* block = arena->blocks;
+
+    if (block->used + size > block->size) {
+        arena->blockSize *= 2;
+        size_t blockSize = size > arena->blockSize ? size : arena->blockSize;
+        block = newBlock(blockSize);
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->totalBytes += blockSize;
+    }
+
+    void* pointer = block->data + block->used;
+    block->used += size;
+    memset(pointer, 0, size);
+    return pointer;
+}
+
+// Libera de una vez todo lo que se pidió a la arena, y la arena misma:
+void arenaDestroy(t_memoriaArena* arena) {
+    if (!arena)
+        return;
+    t_arenaBlock* block = arena->blocks;
+    while (block) {
+        t_arenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
@@ -0,0 +1,29 @@
+#ifndef MEMORIA_ARENA_H
+#define MEMORIA_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 16
+
+// Arena de memoria de un proceso: todo lo que es del proceso (su estructura, tablas de páginas, lista de marcos,
+// bitmap de páginas sucias e instrucciones) se saca de acá con arenaAlloc, y se libera todo junto con arenaDestroy.
+// Los bloques se piden con un tamaño estimado al crear el proceso, así que normalmente la arena es un único bloque.
+// data va alineado a ARENA_ALIGNMENT dentro del bloque (sin eso quedaría en el offset 24), así lo que se saca de él también queda alineado:
+typedef struct t_arenaBlock {
+    struct t_arenaBlock* next;
+    size_t size;
+    size_t used;
+    _Alignas(ARENA_ALIGNMENT) char data[];
+} t_arenaBlock;
+
+typedef struct {
+    t_arenaBlock* blocks;
+    size_t blockSize;
+    size_t totalBytes;
+} t_memoriaArena;
+
+t_memoriaArena* arenaCreate(size_t expectedBytes);
+void* arenaAlloc(t_memoriaArena* arena, size_t size);
+void arenaDestroy(t_memoriaArena* arena);
+
+#endif
@@ -0,0 +1,210 @@
+#include "memoria.h"
+#include "memoriaDump.h"
+#include <commons/temporal.h>
+
+// Los dumps son incrementales: el primer DUMP_MEMORY de un proceso escribe la imagen completa (<PID>-<TIMESTAMP>.dmp),
+// y los siguientes escriben un .delta solo con las páginas que se modificaron desde el dump anterior.
+// Para saber qué páginas cambiaron, cada proceso tiene un bitmap de páginas sucias (dirtyPages) que marca el handler de WRITE.
+// La imagen completa de cualquier momento se rearma con rebuildDumpImage (./bin/memoria --rebuild-dump ...).
+//
+// Los hilos de las CPUs marcan el bitmap mientras se hace un dump, así que cada byte se toca con operaciones atómicas:
+// el escritor copia los datos y recién después marca la página (OR atómico), y el dump primero se queda con el bitmap
+// (intercambiando cada byte por 0) y recién después copia las páginas. Una escritura que marca antes del intercambio ya está en la copia,
+// y una que marca después queda sucia para el próximo delta: ninguna se pierde.
+
+#define DIRTY_MASK(page) ((uint8_t)(0x80 >> ((page) % 8))) // el bitmap es MSB_FIRST
+
+static inline uint8_t* dirtyByte(t_memoriaProcess* proc, int page) {
+    return (uint8_t*)proc->dirtyPages->bitarray + page / 8;
+}
+
+// Marca como sucias las páginas del proceso que caen en el rango físico escrito. Se llama después de copiar los datos:
+void markDirtyRange(t_memoriaProcess* proc, int physicalAddress, int size) {
+    if (!proc->dirtyPages || size <= 0)
+        return;
+
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    int firstFrame = physicalAddress / pageSize;
+    int lastFrame = (physicalAddress + size - 1) / pageSize;
+
+    for (int frame = firstFrame; frame <= lastFrame; frame++) {
+        int page = framePages[frame];
+        if (page >= 0 && page < proc->numPages && proc->frames[page] == frame)
+            __atomic_fetch_or(dirtyByte(proc, page), DIRTY_MASK(page), __ATOMIC_RELEASE);
+    }
+}
+
+// Se queda con el bitmap de páginas sucias dejándolo en cero, byte por byte. Retorna la copia (con free) y en dirtyCount cuántas había:
+static uint8_t* takeDirtyPages(t_memoriaProcess* proc, int* dirtyCount) {
+    int bytes = (proc->numPages + 7) / 8;
+    uint8_t* taken = calloc(bytes > 0 ? bytes : 1, 1);
+    *dirtyCount = 0;
+    for (int i = 0; i < bytes; i++) {
+        taken[i] = __atomic_exchange_n((uint8_t*)proc->dirtyPages->bitarray + i, 0, __ATOMIC_ACQ_REL);
+        *dirtyCount += __builtin_popcount(taken[i]);
+    }
+    return taken;
+}
+
+// Si el dump no se pudo escribir, las páginas que se habían tomado vuelven a quedar sucias:
+static void restoreDirtyPages(t_memoriaProcess* proc, uint8_t* taken) {
+    for (int i = 0; i < (proc->numPages + 7) / 8; i++) {
+        if (taken[i])
+            __atomic_fetch_or((uint8_t*)proc->dirtyPages->bitarray + i, taken[i], __ATOMIC_RELEASE);
+    }
+}
+
+// El timestamp lleva la fecha, así no chocan los dumps de un mismo proceso hechos a la misma hora en días distintos:
+static char* dumpFileName(t_memoriaProcess* proc, const char* extension) {
+    char* timestamp = temporal_get_string_time("%Y-%m-%d_%H:%M:%S:%MS");
+    char* fileName = string_from_format("%s%d-%s.%s", getMemoriaConfig()->DUMP_PATH, proc->pid, timestamp, extension);
+    free(timestamp);
+    return fileName;
+}
+
+// Escribe la imagen completa del proceso, página por página en orden lógico:
+static int writeBaseImage(t_memoriaProcess* proc, FILE* file) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    for (int i = 0; i < proc->numPages; i++) {
+        if (fwrite((char*)memory + proc->frames[i] * pageSize, pageSize, 1, file) != 1)
+            return 0;
+    }
+    return 1;
+}
+
+// Escribe solo las páginas sucias (las del bitmap tomado), precedidas por la cabecera del delta:
+static int writeDeltaImage(t_memoriaProcess* proc, FILE* file, uint8_t* dirty, int dirtyCount) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+
+    tDumpDeltaHeader header;
+    memcpy(header.magic, "DMPD", 4);
+    header.pid = proc->pid;
+    header.pageSize = pageSize;
+    header.numPages = proc->numPages;
+    header.sequence = proc->dumpSequence;
+    header.dirtyCount = dirtyCount;
+
+    if (fwrite(&header, sizeof(tDumpDeltaHeader), 1, file) != 1)
+        return 0;
+
+    for (uint32_t i = 0; i < (uint32_t)proc->numPages; i++) {
+        if (!(dirty[i / 8] & DIRTY_MASK(i)))
+            continue;
+        if (fwrite(&i, sizeof(uint32_t), 1, file) != 1)
+            return 0;
+        if (fwrite((char*)memory + proc->frames[i] * pageSize, pageSize, 1, file) != 1)
+            return 0;
+    }
+    return 1;
+}
+
+// Hace el dump del proceso (base o delta según corresponda) y limpia su bitmap de páginas sucias.
+// Retorna 1 si el dump se escribió, o 0 si falló:
+int dumpProcess(t_memoriaProcess* proc) {
+    if (proc->suspended) {
+        log_error(memoriaLog, "## (%d) - No se puede hacer el dump de un proceso suspendido", proc->pid);
+        return 0;
+    }
+
+    // El bitmap se toma antes de copiar páginas también para la imagen base: lo que se escriba desde acá va al próximo delta
+    int isBase = proc->dumpSequence == 0;
+    int dirtyCount;
+    uint8_t* dirty = takeDirtyPages(proc, &dirtyCount);
+
+    char* fileName = dumpFileName(proc, isBase ? "dmp" : "delta");
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        log_error(memoriaLog, "## (%d) - No se pudo crear el archivo de dump '%s'", proc->pid, fileName);
+        restoreDirtyPages(proc, dirty);
+        free(dirty);
+        free(fileName);
+        return 0;
+    }
+
+    int ok = isBase ? writeBaseImage(proc, file) : writeDeltaImage(proc, file, dirty, dirtyCount);
+    fclose(file);
+
+    if (!ok) {
+        log_error(memoriaLog, "## (%d) - Error escribiendo el dump '%s'", proc->pid, fileName);
+        restoreDirtyPages(proc, dirty);
+        free(dirty);
+        free(fileName);
+        return 0;
+    }
+    free(dirty);
+
+    if (isBase)
+        log_info(memoriaLog, "## (%d) - Dump base: %s (%d páginas)", proc->pid, fileName, proc->numPages);
+    else
+        log_info(memoriaLog, "## (%d) - Dump incremental #%d: %s (%d de %d páginas modificadas)", proc->pid, proc->dumpSequence, fileName, dirtyCount, proc->numPages);
+
+    proc->dumpSequence++;
+    free(fileName);
+    return 1;
+}
+
+// Rearma la imagen completa aplicando en orden los deltas sobre la imagen base, y la escribe en outputPath.
+// Retorna 1 si pudo, o 0 si algún archivo no existe o no es un delta válido del mismo proceso:
+int rebuildDumpImage(char* basePath, char** deltaPaths, int deltaCount, char* outputPath) {
+    FILE* base = fopen(basePath, "rb");
+    if (!base) {
+        log_error(memoriaLog, "No se pudo abrir el dump base '%s'", basePath);
+        return 0;
+    }
+    fseek(base, 0, SEEK_END);
+    long imageSize = ftell(base);
+    rewind(base);
+
+    char* image = malloc(imageSize > 0 ? imageSize : 1);
+    if (imageSize > 0 && fread(image, imageSize, 1, base) != 1) {
+        log_error(memoriaLog, "Error leyendo el dump base '%s'", basePath);
+        fclose(base);
+        free(image);
+        return 0;
+    }
+    fclose(base);
+
+    int ok = 1;
+    int32_t pid = -1;
+    for (int d = 0; d < deltaCount && ok; d++) {
+        FILE* delta = fopen(deltaPaths[d], "rb");
+        tDumpDeltaHeader header;
+
+        if (!delta || fread(&header, sizeof(tDumpDeltaHeader), 1, delta) != 1 || memcmp(header.magic, "DMPD", 4) != 0
+            || (pid >= 0 && (int32_t)header.pid != pid) || (long)header.numPages * header.pageSize != imageSize) {
+            log_error(memoriaLog, "El archivo '%s' no es un delta válido para el dump base '%s'", deltaPaths[d], basePath);
+            if (delta)
+                fclose(delta);
+            ok = 0;
+            break;
+        }
+        pid = header.pid;
+
+        for (uint32_t i = 0; i < header.dirtyCount; i++) {
+            uint32_t page;
+            if (fread(&page, sizeof(uint32_t), 1, delta) != 1 || page >= header.numPages
+                || fread(image + (long)page * header.pageSize, header.pageSize, 1, delta) != 1) {
+                log_error(memoriaLog, "El delta '%s' está truncado", deltaPaths[d]);
+                ok = 0;
+                break;
+            }
+        }
+        fclose(delta);
+    }
+
+    if (ok) {
+        FILE* output = fopen(outputPath, "wb");
+        if (!output || (imageSize > 0 && fwrite(image, imageSize, 1, output) != 1)) {
+            log_error(memoriaLog, "No se pudo escribir la imagen rearmada en '%s'", outputPath);
+            ok = 0;
+        }
+        if (output)
+            fclose(output);
+    }
+
+    if (ok)
+        log_info(memoriaLog, "Imagen rearmada en '%s' a partir de '%s' y %d deltas", outputPath, basePath, deltaCount);
+
+    free(image);
+    return ok;
+}
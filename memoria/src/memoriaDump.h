@@ -0,0 +1,21 @@
+#ifndef MEMORIA_DUMP_H
+#define MEMORIA_DUMP_H
+
+#include <stdint.h>
+#include "memoriaServer.h"
+
+// Cabecera de un dump incremental (.delta), le siguen dirtyCount registros [índice de página (uint32_t) | contenido de la página]:
+typedef struct {
+    char magic[4];       // "DMPD"
+    uint32_t pid;
+    uint32_t pageSize;
+    uint32_t numPages;
+    uint32_t sequence;   // número de dump del proceso (el base es el 0)
+    uint32_t dirtyCount;
+} tDumpDeltaHeader;
+
+void markDirtyRange(t_memoriaProcess* proc, int physicalAddress, int size);
+int dumpProcess(t_memoriaProcess* proc);
+int rebuildDumpImage(char* basePath, char** deltaPaths, int deltaCount, char* outputPath);
+
+#endif
@@ -0,0 +1,161 @@
+#include "memoriaLz.h"
+#include <string.h>
+
+// Compresor de la familia LZ77 (formato parecido al de LZ4) que usa el tier comprimido de SWAP.
+// El bloque comprimido es una secuencia de: [token][literales][offset][largo del match], donde el token tiene
+// en los 4 bits altos la cantidad de literales, y en los 4 bits bajos el largo del match menos LZ_MIN_MATCH.
+// Si alguno de los dos no entra en 4 bits (vale 15), le siguen bytes extra de 255 hasta completar el largo.
+// La última secuencia solo tiene literales, así el descompresor sabe que terminó cuando consume toda la entrada.
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 12
+#define LZ_MAX_OFFSET 0xFFFF
+
+static uint32_t lzHash(uint32_t sequence){
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Escribe un largo extendido (los bytes que siguen al token cuando el nibble vale 15), retorna el nuevo offset o -1 si no entra:
+static int lzWriteLength(uint8_t* dst, int op, int dstCapacity, int length){
+    while (length >= 255){
+        if (op >= dstCapacity)
+            return -1;
+        dst[op++] = 255;
+        length -= 255;
+    }
+    if (op >= dstCapacity)
+        return -1;
+    dst[op++] = (uint8_t)length;
+    return op;
+}
+
+// Escribe una secuencia completa, si matchLength es 0 es la secuencia final (solo literales):
+static int lzEmitSequence(uint8_t* dst, int op, int dstCapacity, const uint8_t* literals, int literalLength, int offset, int matchLength){
+    if (op >= dstCapacity)
+        return -1;
+
+    int tokenPosition = op++;
+    int matchCode = matchLength ? matchLength - LZ_MIN_MATCH : 0;
+    dst[tokenPosition] = (uint8_t)(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+
+    if (literalLength >= 15 && (op = lzWriteLength(dst, op, dstCapacity, literalLength - 15)) < 0)
+        return -1;
+
+    if (op + literalLength > dstCapacity)
+        return -1;
+    memcpy(dst + op, literals, literalLength);
+    op += literalLength;
+
+    if (!matchLength)
+        return op;
+
+    if (op + 2 > dstCapacity)
+        return -1;
+    dst[op++] = (uint8_t)(offset & 0xFF);
+    dst[op++] = (uint8_t)(offset >> 8);
+
+    if (matchCode >= 15 && (op = lzWriteLength(dst, op, dstCapacity, matchCode - 15)) < 0)
+        return -1;
+
+    return op;
+}
+
+// Comprime srcSize bytes de src en dst. Retorna el tamaño comprimido, o -1 si el resultado no entra en dstCapacity
+// (el que llama usa eso para detectar que la página no es compresible y guardarla tal cual):
+int lzCompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity){
+    int table[1 << LZ_HASH_BITS];
+    for (int i = 0; i < (1 << LZ_HASH_BITS); i++)
+        table[i] = -1;
+
+    int ip = 0;
+    int anchor = 0;
+    int op = 0;
+
+    while (ip + LZ_MIN_MATCH <= srcSize){
+        uint32_t sequence;
+        memcpy(&sequence, src + ip, sizeof(uint32_t));
+        uint32_t hash = lzHash(sequence);
+        int reference = table[hash];
+        table[hash] = ip;
+
+        if (reference < 0 || ip - reference > LZ_MAX_OFFSET || memcmp(src + reference, src + ip, LZ_MIN_MATCH) != 0){
+            ip++;
+            continue;
+        }
+
+        int matchLength = LZ_MIN_MATCH;
+        while (ip + matchLength < srcSize && src[reference + matchLength] == src[ip + matchLength])
+            matchLength++;
+
+        op = lzEmitSequence(dst, op, dstCapacity, src + anchor, ip - anchor, ip - reference, matchLength);
+        if (op < 0)
+            return -1;
+
+        ip += matchLength;
+        anchor = ip;
+    }
+
+    return lzEmitSequence(dst, op, dstCapacity, src + anchor, srcSize - anchor, 0, 0);
+}
+
+// Lee un largo extendido, retorna -1 si la entrada está truncada:
+static int lzReadLength(const uint8_t* src, int* ip, int srcSize){
+    int length = 0;
+    uint8_t byte;
+    do {
+        if (*ip >= srcSize)
+            return -1;
+        byte = src[(*ip)++];
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+// Descomprime un bloque generado por lzCompress. Retorna la cantidad de bytes escritos en dst, o -1 si el bloque está corrupto:
+int lzDecompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity){
+    int ip = 0;
+    int op = 0;
+
+    while (ip < srcSize){
+        uint8_t token = src[ip++];
+
+        int literalLength = token >> 4;
+        if (literalLength == 15){
+            int extra = lzReadLength(src, &ip, srcSize);
+            if (extra < 0)
+                return -1;
+            literalLength += extra;
+        }
+
+        if (ip + literalLength > srcSize || op + literalLength > dstCapacity)
+            return -1;
+        memcpy(dst + op, src + ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == srcSize)
+            break;
+
+        if (ip + 2 > srcSize)
+            return -1;
+        int offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+
+        int matchLength = token & 0x0F;
+        if (matchLength == 15){
+            int extra = lzReadLength(src, &ip, srcSize);
+            if (extra < 0)
+                return -1;
+            matchLength += extra;
+        }
+        matchLength += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || op + matchLength > dstCapacity)
+            return -1;
+
+        // Se copia byte a byte porque el match se puede solapar con lo que se está escribiendo (ej: páginas con patrones repetidos):
+        for (int i = 0; i < matchLength; i++, op++)
+            dst[op] = dst[op - offset];
+    }
+
+    return op;
+}
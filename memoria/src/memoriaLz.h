@@ -0,0 +1,9 @@
+#ifndef MEMORIA_LZ_H
+#define MEMORIA_LZ_H
+
+#include <stdint.h>
+
+int lzCompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity);
+int lzDecompress(const uint8_t* src, int srcSize, uint8_t* dst, int dstCapacity);
+
+#endif
@@ -0,0 +1,128 @@
+#include "memoria.h"
+#include "memoriaReservation.h"
+
+static t_list* reservations; // lista de t_memoryReservation* pendientes de commit
+static int nextReservationToken;
+static pthread_mutex_t reservationMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void initReservations(void) {
+    reservations = list_create();
+    nextReservationToken = 0;
+}
+
+static void destroyReservation(void* voidReservation) {
+    t_memoryReservation* reservation = voidReservation;
+    releaseFrames(reservation->frames, reservation->pages);
+    free(reservation->frames);
+    free(reservation);
+}
+
+// Saca de la lista la reserva con ese token y ese pid (-1 en cualquiera de los dos: no se filtra por ese campo), o retorna NULL si no hay.
+// Se recorre a mano en lugar de pasarle a la lista una función anidada que lea token / pid, que necesitaría stack ejecutable:
+static t_memoryReservation* removeReservation(int token, int pid) {
+    for (int i = 0; i < list_size(reservations); i++) {
+        t_memoryReservation* reservation = list_get(reservations, i);
+        if ((token < 0 || reservation->token == token) && (pid < 0 || reservation->pid == pid))
+            return list_remove(reservations, i);
+    }
+    return NULL;
+}
+
+void destroyReservations(void) {
+    pthread_mutex_lock(&reservationMutex);
+    list_destroy_and_destroy_elements(reservations, destroyReservation);
+    pthread_mutex_unlock(&reservationMutex);
+}
+
+// Reserva los marcos que necesita un proceso de sizeBytes. Retorna el token de la reserva, o -1 si no hay espacio.
+// Si el pid ya tenía una reserva, se reemplaza:
+int createReservation(int pid, int sizeBytes) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    int pages = (sizeBytes > 0) ? (int)ceil((double)sizeBytes / pageSize) : 0;
+
+    pthread_mutex_lock(&reservationMutex);
+
+    t_memoryReservation* previous = removeReservation(-1, pid);
+    if (previous)
+        destroyReservation(previous);
+
+    int* frames;
+    if (!reserveFrames(pages, &frames)) {
+        pthread_mutex_unlock(&reservationMutex);
+        log_info(memoriaLog, "## (%d) - Reserva rechazada: necesita %d páginas", pid, pages);
+        return -1;
+    }
+
+    t_memoryReservation* reservation = malloc(sizeof(t_memoryReservation));
+    reservation->token = nextReservationToken++;
+    reservation->pid = pid;
+    reservation->pages = pages;
+    reservation->frames = frames;
+    list_add(reservations, reservation);
+
+    pthread_mutex_unlock(&reservationMutex);
+
+    log_info(memoriaLog, "## (%d) - Reserva %d creada: %d páginas", pid, reservation->token, pages);
+    return reservation->token;
+}
+
+// Commit de la reserva: si existe la reserva token del pid y es de la cantidad de páginas pedida, entrega sus marcos en framesOut y la elimina.
+// Retorna 1 si había reserva, 0 si no (token -1, o una reserva que ya no existe: entonces hay que reservar marcos normalmente):
+int takeReservedFrames(int token, int pid, int pages, int** framesOut) {
+    if (token < 0)
+        return 0;
+
+    pthread_mutex_lock(&reservationMutex);
+
+    t_memoryReservation* reservation = removeReservation(token, pid);
+
+    if (!reservation) {
+        pthread_mutex_unlock(&reservationMutex);
+        log_warning(memoriaLog, "## (%d) - La reserva %d no existe, se reservan marcos de nuevo", pid, token);
+        return 0;
+    }
+
+    if (reservation->pages != pages) {
+        // No debería pasar (el Kernel reserva con el mismo tamaño que carga), se devuelve la reserva y se reserva de nuevo
+        log_warning(memoriaLog, "## (%d) - La reserva %d era de %d páginas pero se cargan %d", pid, reservation->token, reservation->pages, pages);
+        destroyReservation(reservation);
+        pthread_mutex_unlock(&reservationMutex);
+        return 0;
+    }
+
+    *framesOut = reservation->frames;
+    log_info(memoriaLog, "## (%d) - Reserva %d confirmada", pid, reservation->token);
+    free(reservation);
+
+    pthread_mutex_unlock(&reservationMutex);
+    return 1;
+}
+
+// Libera una reserva que no se va a usar, devolviendo sus marcos:
+void releaseReservation(int token) {
+    if (token < 0)
+        return;
+
+    pthread_mutex_lock(&reservationMutex);
+
+    t_memoryReservation* reservation = removeReservation(token, -1);
+    if (reservation) {
+        log_info(memoriaLog, "## (%d) - Reserva %d liberada", reservation->pid, token);
+        destroyReservation(reservation);
+    }
+
+    pthread_mutex_unlock(&reservationMutex);
+}
+
+// Libera la reserva que pueda tener el pid (al removerlo o suspenderlo ya no se va a cargar con ella):
+void releaseReservationOfPid(int pid) {
+    pthread_mutex_lock(&reservationMutex);
+
+    t_memoryReservation* reservation = removeReservation(-1, pid);
+    if (reservation) {
+        log_info(memoriaLog, "## (%d) - Reserva %d liberada", pid, reservation->token);
+        destroyReservation(reservation);
+    }
+
+    pthread_mutex_unlock(&reservationMutex);
+}
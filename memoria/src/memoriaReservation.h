@@ -0,0 +1,22 @@
+#ifndef MEMORIA_RESERVATION_H
+#define MEMORIA_RESERVATION_H
+
+// Reserva de espacio pedida por el Kernel antes de mandar la carga de un proceso.
+// Los marcos se sacan del bitmap al reservar, así que el espacio libre informado ya no los cuenta,
+// y la carga del proceso (commit) los usa directamente:
+typedef struct {
+    int token;
+    int pid;
+    int pages;
+    int* frames;
+} t_memoryReservation;
+
+void initReservations(void);
+void destroyReservations(void);
+
+int createReservation(int pid, int sizeBytes);
+int takeReservedFrames(int token, int pid, int pages, int** framesOut);
+void releaseReservation(int token);
+void releaseReservationOfPid(int pid);
+
+#endif
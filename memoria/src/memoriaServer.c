@@ -7,7 +7,12 @@ int listeningSocket;
 
 void*          memory;           // bloque de RAM simulada
 t_bitarray*    frameBitmap;      // bitmap de marcos libres/ocupados
+int*           framePages;       // marco → página lógica que lo usa, para saber qué página marcar como sucia en un WRITE
+int            freeFrameCount;   // cantidad exacta de marcos libres
+static int     nextFreeFrameHint;
+pthread_mutex_t frameMutex = PTHREAD_MUTEX_INITIALIZER; // protege el bitmap de marcos y el contador
 t_dictionary*  activeProcesses;  // diccionario PID → t_memoriaProcess*
+static pthread_cond_t unpinnedProcess = PTHREAD_COND_INITIALIZER; // se avisa cuando un proceso deja de estar fijado por un pedido
 
 // Esta función es un hilo efímero, que es creado por el hilo de escucha, es la función específica que usa la Memoria para
 // discriminar qué módulo se le conectó, analizando el handshake recibido (es bloqueante porque se queda resperando a recibir el paquete del handshake),
@@ -43,6 +48,7 @@ void* establishingMemoriaConnection(void* voidPointerConnectionSocket){
             uint32_t tamanioPagina = getMemoriaConfig()->TAM_PAGINA;
             uint32_t entradasPorTabla = getMemoriaConfig()->ENTRADAS_POR_TABLA;
             uint32_t cantidadNiveles = getMemoriaConfig()->CANTIDAD_NIVELES;
+            uint32_t retardoMemoria = getMemoriaConfig()->RETARDO_MEMORIA;
 
 
             log_info(memoriaLog, "Enviando a CPU: TAM_PAGINA=%u, ENTRADAS_POR_TABLA=%u, CANTIDAD_NIVELES=%u",tamanioPagina, entradasPorTabla, cantidadNiveles);
@@ -51,6 +57,7 @@ void* establishingMemoriaConnection(void* voidPointerConnectionSocket){
             addToPackage(responsePackage, &tamanioPagina, sizeof(uint32_t));
             addToPackage(responsePackage, &entradasPorTabla, sizeof(uint32_t));
             addToPackage(responsePackage, &cantidadNiveles, sizeof(uint32_t));
+            addToPackage(responsePackage, &retardoMemoria, sizeof(uint32_t));
 
             sendPackage(responsePackage, connectionSocket);
             log_info(memoriaLog, "Enviada respuesta del handshake a CPU Dispatch.");
@@ -91,6 +98,87 @@ void* establishingMemoriaConnection(void* voidPointerConnectionSocket){
     return NULL;
 }
 
+// Busca el proceso en activeProcesses y lo fija para el pedido que lo va a usar: mientras tenga pedidos fijándolo, REMOVE y SUSPEND
+// esperan antes de liberar sus marcos o su arena (ver waitForOtherPins). Todo pedido que lo obtiene así tiene que llamar a unpinActiveProcess.
+// Retorna NULL si el PID no está activo:
+t_memoriaProcess* pinActiveProcess(int pid){
+    char* pidKey = string_itoa(pid);
+    pthread_mutex_lock(&activeProcessesMutex);
+    t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
+    if (proc)
+        proc->pins++;
+    pthread_mutex_unlock(&activeProcessesMutex);
+    free(pidKey);
+    return proc;
+}
+
+void unpinActiveProcess(t_memoriaProcess* proc){
+    if (!proc)
+        return;
+    pthread_mutex_lock(&activeProcessesMutex);
+    proc->pins--;
+    pthread_cond_broadcast(&unpinnedProcess);
+    pthread_mutex_unlock(&activeProcessesMutex);
+}
+
+// La llama quien tiene fijado el proceso y lo va a desarmar (REMOVE o SUSPEND): espera a que terminen los demás pedidos que lo usan.
+// Para que no lleguen pedidos nuevos, REMOVE lo saca antes de activeProcesses, y SUSPEND hace antes el shootdown:
+void waitForOtherPins(t_memoriaProcess* proc){
+    pthread_mutex_lock(&activeProcessesMutex);
+    while (proc->pins > 1)
+        pthread_cond_wait(&unpinnedProcess, &activeProcessesMutex);
+    pthread_mutex_unlock(&activeProcessesMutex);
+}
+
+// Contenido de la entrada entry_index de la tabla de nivel level del proceso: en los niveles intermedios, el puntero a la tabla
+// siguiente; en el último, el marco. La tabla de nivel 1 es la raíz del proceso, y la de los otros niveles la manda la CPU (table).
+// Retorna -1 si el proceso o la tabla no existen:
+static uint64_t readPageTableEntry(t_memoriaProcess* proc, int pid, uint64_t table, int level, int entry_index){
+    log_info(memoriaLog, "PID: %d -> Petición de TP [Nivel: %d, Entrada: %d, Addr de Tabla: %lu]", pid, level, entry_index, (unsigned long)table);
+
+    uint64_t content = -1;
+
+    if (!proc) {
+        log_error(memoriaLog, "¡ERROR CRÍTICO! PID: %d no encontrado.", pid);
+    } else {
+        metricAdd(&proc->metrics.pageTableAccesses, 1);
+        void* table_to_read = level == 1 ? proc->pageTables : (void*)(uintptr_t)table;
+
+        if (table_to_read == NULL) {
+            log_error(memoriaLog, "¡ERROR CRÍTICO! Intento de acceso a tabla de nivel %d para PID %d, pero el puntero es NULO.", level, pid);
+        } else if (level < proc->levels) {
+            content = (uint64_t)(uintptr_t)((void**)table_to_read)[entry_index];
+        } else {
+            content = (uint64_t)((int*)table_to_read)[entry_index];
+        }
+    }
+
+    log_info(memoriaLog, "PID: %d -> Respuesta de TP [Nivel: %d, Entrada: %d] -> Contenido: %lu", pid, level, entry_index, (unsigned long)content);
+    return content;
+}
+
+// Lectura de la CPU: cuenta la métrica y retorna el puntero a los datos dentro de la RAM simulada (se copian al armar la respuesta):
+static void* readForCpu(t_memoriaProcess* proc, int pid, int physical_address, int size){
+    if (proc) {
+        metricAdd(&proc->metrics.reads, 1);
+        metricAdd(&proc->metrics.bytesRead, size);
+    }
+    log_info(memoriaLog, "PID: %d - Acción: LEER - Dir. Física: %d - Tamaño: %d", pid, physical_address, size);
+    return memory + physical_address;
+}
+
+static void writeForCpu(t_memoriaProcess* proc, int pid, int physical_address, int size, void* data){
+    if (proc) {
+        metricAdd(&proc->metrics.writes, 1);
+        metricAdd(&proc->metrics.bytesWritten, size);
+    }
+    log_info(memoriaLog, "PID: %d - Acción: ESCRIBIR - Dir. Física: %d - Tamaño: %d", pid, physical_address, size);
+    memcpy(memory + physical_address, data, size);
+    // La página se marca después de copiar, así un dump que toma el bitmap en el medio no la pierde (ver memoriaDump.c):
+    if (proc)
+        markDirtyRange(proc, physical_address, size);
+}
+
 // Es la función del hilo de Memoria de recepción de información desde CPU Dispatch.
 // Dependiendo del código de operación del paquete, decide qué hacer.
 // Es bloqueante en receivePackage:
@@ -128,7 +216,7 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
             case CPU_TO_MEMORIA_FETCH_INSTRUCTION: {
 
                 log_info(memoriaLog, "Aplicando retardo de memoria para FETCH_INSTRUCTION...");
-                usleep(getMemoriaConfig()->RETARDO_MEMORIA * 1000);
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
                 // Extrae el PID y el PC que CPU envió 
                 t_list* data = packageToList(package);
                 int pid = extractIntElementFromList(data, 0);
@@ -138,21 +226,24 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
 
                 log_info(memoriaLog, "[FETCH] CPU solicita instrucción: PID=%d, PC=%d", pid, programCounter);
 
-                char* pidKey = string_itoa(pid);
-                t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
-                free(pidKey);
+                t_memoriaProcess* proc = pinActiveProcess(pid);
 
                 char* inst;
+                uint32_t imageId = 0;
                 if (proc != NULL && programCounter < proc->instructionCount) {
+                    metricAdd(&proc->metrics.instructionFetches, 1);
                     inst = string_duplicate(proc->instructions[programCounter]);
+                    imageId = proc->instructionImageId;
                 } else {
                     inst = string_from_format("EXIT");
                 }
+                unpinActiveProcess(proc);
                 
                 log_info(memoriaLog, "INSTRUCCION A ENVIAR %s", inst);
                 
                 tPackage* rsp =  createPackage(MEMORIA_TO_CPU_SEND_INSTRUCTION);
                 addToPackage(rsp, inst, strlen(inst) + 1);
+                addToPackage(rsp, &imageId, sizeof(uint32_t));
                 
                 sendPackage(rsp, connectionSocket);
 
@@ -164,45 +255,15 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
 
             case CPU_TO_MEMORIA_GET_PAGE_TABLE_ENTRY: {
                 log_info(memoriaLog, "Aplicando retardo de memoria para acceso a Tabla de Páginas...");
-                usleep(getMemoriaConfig()->RETARDO_MEMORIA * 1000);
-                list = packageToList(package);
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
                 int pid = extractIntElementFromList(list, 0);
                 uint64_t table_addr_from_cpu = extractUint64ElementFromList(list, 1); // Usamos la nueva función
                 int level_requested = extractIntElementFromList(list, 2);
                 int entry_index = extractIntElementFromList(list, 3);
-                
-                log_info(memoriaLog, "PID: %d -> Petición de TP [Nivel: %d, Entrada: %d, Addr de Tabla: %lu]", pid, level_requested, entry_index, (unsigned long)table_addr_from_cpu);
-
-                char* pidKey = string_itoa(pid);
-                t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
-                free(pidKey);
-
-                uint64_t content_to_send = -1; // Usamos uint64_t para la respuesta
-
-                if (!proc) {
-                    log_error(memoriaLog, "¡ERROR CRÍTICO! PID: %d no encontrado.", pid);
-                } else {
-                    proc->accesos_a_tabla_paginas++;
-                    void* table_to_read;
-                    if (level_requested == 1) {
-                        table_to_read = proc->pageTables;
-                    } else {
-                        table_to_read = (void*)(uintptr_t)table_addr_from_cpu;
-                    }
-
-                    if (table_to_read == NULL) {
-                        log_error(memoriaLog, "¡ERROR CRÍTICO! Intento de acceso a tabla de nivel %d para PID %d, pero el puntero es NULO.", level_requested, pid);
-                    } else {
-                        if (level_requested < proc->levels) {
-                            void* next_table_ptr = ((void**)table_to_read)[entry_index];
-                            content_to_send = (uint64_t)(uintptr_t)next_table_ptr;
-                        } else {
-                            content_to_send = (uint64_t)((int*)table_to_read)[entry_index];
-                        }
-                    }
-                }
 
-                log_info(memoriaLog, "PID: %d -> Respuesta de TP [Nivel: %d, Entrada: %d] -> Contenido: %lu", pid, level_requested, entry_index, (unsigned long)content_to_send);
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+                uint64_t content_to_send = readPageTableEntry(proc, pid, table_addr_from_cpu, level_requested, entry_index);
+                unpinActiveProcess(proc);
 
                 tPackage* response = createPackage(MEMORIA_TO_CPU_PAGE_TABLE_ENTRY);
                 addToPackage(response, &content_to_send, sizeof(uint64_t)); // Enviamos como uint64_t
@@ -214,7 +275,7 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
 
             case CPU_TO_MEMORIA_READ: {
                 log_info(memoriaLog, "Aplicando retardo de memoria para LECTURA...");
-                usleep(getMemoriaConfig()->RETARDO_MEMORIA * 1000);
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
                 
                 t_list* params = packageToList(package);
                 int pid = extractIntElementFromList(params, 0);
@@ -222,74 +283,121 @@ void* serverThreadForCpuDispatch(void* voidPointerConnectionSocket){
                 int size = extractIntElementFromList(params, 2);
                 list_destroy_and_destroy_elements(params, free);
 
-                // treamos para metricas
-                char* pidKey = string_itoa(pid);
-                t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
-                free(pidKey);
-                if (proc) {
-                    proc->lecturas_en_memoria++;
-                    log_info(memoriaLog, "PID: %d - Métrica de lectura incrementada a: %d", pid, proc->lecturas_en_memoria);
-                }
-                
-                log_info(memoriaLog, "PID: %d - Acción: LEER - Dir. Física: %d - Tamaño: %d", pid, physical_address, size);
-
-                // Crear un buffer temporal para leer desde nuestra memoria principal
-                void* buffer_out = malloc(size);
-                memcpy(buffer_out, memory + physical_address, size);
-
-                // Enviar la respuesta a la CPU
+                // Enviar la respuesta a la CPU, leyendo directo de nuestra memoria principal
+                t_memoriaProcess* proc = pinActiveProcess(pid);
                 tPackage* response = createPackage(MEMORIA_TO_CPU_READ_RESPONSE);
-                addToPackage(response, buffer_out, size);
+                addToPackage(response, readForCpu(proc, pid, physical_address, size), size);
+                unpinActiveProcess(proc);
                 sendPackage(response, connectionSocket);
-
-                free(buffer_out); // Liberamos el buffer temporal
                 break;
             }
 
             case CPU_TO_MEMORIA_WRITE: {
                 log_info(memoriaLog, "Aplicando retardo de memoria para ESCRITURA...");
-                usleep(getMemoriaConfig()->RETARDO_MEMORIA * 1000);
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
                 t_list* params = packageToList(package);
                 int pid = extractIntElementFromList(params, 0);
                 int physical_address = extractIntElementFromList(params, 1); 
                 int size = extractIntElementFromList(params, 2);
-                void* data_to_write = malloc(size);
-                memcpy(data_to_write, list_get(params, 3), size); 
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+                writeForCpu(proc, pid, physical_address, size, list_get(params, 3));
+                unpinActiveProcess(proc);
                 list_destroy_and_destroy_elements(params, free);
 
-                char* pidKey = string_itoa(pid);
-                t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
-                free(pidKey);
-
-                if (proc) {
-                    proc->escrituras_en_memoria++;
-                    log_info(memoriaLog, "PID: %d - Métrica de escritura incrementada a: %d", pid, proc->escrituras_en_memoria);
-                }
+                tPackage* response = createPackage(MEMORIA_TO_CPU_WRITE_ACK);
+                sendPackage(response, connectionSocket);
+                break;
+            }
 
 
-                log_info(memoriaLog, "PID: %d - Acción: ESCRIBIR - Dir. Física: %d - Tamaño: %d", pid, physical_address, size);
 
-                memcpy(memory + physical_address, data_to_write, size);
-                free(data_to_write);
+            case CPU_TO_MEMORIA_WRITE_PAGES: {
+                // Escritura de páginas completas que la CPU juntó en su caché (write-back): [pid] y luego pares [dirección física | página].
+                // Es un solo acceso a Memoria, así que el retardo se aplica una vez por mensaje:
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
+                t_list* params = packageToList(package);
+                int pid = extractIntElementFromList(params, 0);
+                int pageSize = getMemoriaConfig()->TAM_PAGINA;
+                int pages = (list_size(params) - 1) / 2;
+
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+
+                // Solo se escriben las páginas de un proceso activo en marcos que sigan siendo suyos: una CPU que baja páginas
+                // de un proceso eliminado o suspendido no tiene que pisar marcos que ya se le dieron a otro
+                int written = 0;
+                for (int i = 0; proc && !proc->suspended && i < pages; i++) {
+                    int physical_address = extractIntElementFromList(params, 1 + 2 * i);
+                    int frame = physical_address / pageSize;
+                    int page = framePages[frame];
+                    if (page < 0 || page >= proc->numPages || proc->frames[page] != frame) {
+                        log_error(memoriaLog, "PID: %d - Página descartada: el marco %d no pertenece al proceso", pid, frame);
+                        continue;
+                    }
+                    memcpy(memory + physical_address, list_get(params, 2 + 2 * i), pageSize);
+                    metricAdd(&proc->metrics.writes, 1);
+                    metricAdd(&proc->metrics.bytesWritten, pageSize);
+                    markDirtyRange(proc, physical_address, pageSize);
+                    written++;
+                }
+                if (!proc || proc->suspended)
+                    log_error(memoriaLog, "PID: %d - %d páginas descartadas: el proceso no está activo en memoria", pid, pages);
+                unpinActiveProcess(proc);
+                list_destroy_and_destroy_elements(params, free);
+                log_info(memoriaLog, "PID: %d - Acción: ESCRIBIR - %d páginas completas en un solo mensaje", pid, written);
 
                 tPackage* response = createPackage(MEMORIA_TO_CPU_WRITE_ACK);
                 sendPackage(response, connectionSocket);
                 break;
             }
 
-
+            case CPU_TO_MEMORIA_BATCH: {
+                // Pedidos independientes que la MMU juntó en un solo mensaje (ver tMemoriaBatchKind): Memoria los atiende juntos,
+                // así que, como en WRITE_PAGES, el retardo se aplica una vez por mensaje. La respuesta lleva un elemento por pedido, en orden:
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
+                int pid = extractIntElementFromList(list, 0);
+                int items = 0;
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+                tPackage* response = createPackage(MEMORIA_TO_CPU_BATCH_RESPONSE);
+
+                for (int cursor = 1; cursor < list_size(list); items++) {
+                    tMemoriaBatchKind kind = extractIntElementFromList(list, cursor);
+                    if (kind == MEMORIA_BATCH_PAGE_TABLE_ENTRY) {
+                        uint64_t entry = readPageTableEntry(proc, pid, extractUint64ElementFromList(list, cursor + 1),
+                                                            extractIntElementFromList(list, cursor + 2), extractIntElementFromList(list, cursor + 3));
+                        addToPackage(response, &entry, sizeof(uint64_t));
+                        cursor += 4;
+                    } else if (kind == MEMORIA_BATCH_READ) {
+                        int size = extractIntElementFromList(list, cursor + 2);
+                        addToPackage(response, readForCpu(proc, pid, extractIntElementFromList(list, cursor + 1), size), size);
+                        cursor += 3;
+                    } else {
+                        uint32_t ack = 0;
+                        writeForCpu(proc, pid, extractIntElementFromList(list, cursor + 1), extractIntElementFromList(list, cursor + 2), list_get(list, cursor + 3));
+                        addToPackage(response, &ack, sizeof(uint32_t));
+                        cursor += 4;
+                    }
+                }
+                unpinActiveProcess(proc);
+                log_info(memoriaLog, "PID: %d - %d pedidos de la MMU atendidos en un solo mensaje", pid, items);
+                sendPackage(response, connectionSocket);
+                break;
+            }
 
             case GET_MEMORIA_FREE_SPACE: {
-                int freeSpace = MOCK_FREE_MEMORY;
+                int freeSpace = getFreeMemoryBytes();
 
                 // Armar el paquete de respuesta
                 tPackage* response = createPackage(GET_MEMORIA_FREE_SPACE);
                 addToPackage(response, &freeSpace, sizeof(int));
                 sendPackage(response, connectionSocket);
-                log_info(memoriaLog, "Respondido espacio libre mock: %d bytes", freeSpace);
+                log_info(memoriaLog, "Respondido espacio libre: %d bytes", freeSpace);
                 break;
             }
 
+            case MEMORIA_STATS:
+                sendStatsResponse(connectionSocket, list);
+                break;
+
             case DO_NOTHING:
                 log_info(memoriaLog, "RECIBIDO MENSAJE VACIO DESDE CPU DISPATCH.");
                 break;
@@ -329,6 +437,8 @@ void* serverThreadForCpuInterrupt(void* voidPointerConnectionSocket){
     t_list* list = NULL;
 
     log_info(memoriaLog, "Hilo de servidor para escuchar mensajes del CPU Interrupt creado exitosamente.");
+    // Por esta conexión Memoria le manda a la CPU los shootdowns (ver memoriaShootdown.c), y acá llegan sus confirmaciones
+    shootdownRegisterCpu(connectionSocket);
     while(!finishServer){
         package = receivePackage(connectionSocket);
 
@@ -337,6 +447,7 @@ void* serverThreadForCpuInterrupt(void* voidPointerConnectionSocket){
                 destroyPackage(package);
                 package = NULL;
             }
+            shootdownUnregisterCpu(connectionSocket);
             close(connectionSocket);
             break;
         }
@@ -344,6 +455,9 @@ void* serverThreadForCpuInterrupt(void* voidPointerConnectionSocket){
         list = packageToList(package);
 
         switch(package->operationCode){
+            case CPU_TO_MEMORIA_SHOOTDOWN_ACK:
+                shootdownAcknowledge(connectionSocket, extractIntElementFromList(list, 0));
+                break;
             case CPU_INTERRUPT_TO_MEMORIA_TEST:
                 char* message = extractMessageFromPackage(package);
                 log_info(memoriaLog, "%s", message);
@@ -395,30 +509,50 @@ void* serverThreadForKernel(void* voidPointerConnectionSocket){
         switch (package->operationCode) {
             case KERNEL_TO_MEMORY_REQUEST_TO_LOAD_PROCESS:
                 log_info(memoriaLog, "Aplicando retardo de memoria para KERNEL_TO_MEMORY_REQUEST_TO_LOAD_PROCESS...");
-                usleep(getMemoriaConfig()->RETARDO_MEMORIA * 1000);
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
                 // extraigo pid y tamaño del paquete
                 int pid = extractIntElementFromList(list , 0);
                 char* pseudocodeFileName = extractStringElementFromList(list, 1);
                 int sizeBytes = extractIntElementFromList(list, 2); 
+                // Token de la reserva hecha con KERNEL_TO_MEMORY_RESERVE_SPACE (opcional, -1 si el Kernel no reservó)
+                int reservationToken = list_size(list) > 3 ? extractIntElementFromList(list, 3) : -1;
 
                 log_info(memoriaLog, "## (%d) - INIT_PROC recibido - archivo=%s - tamaño=%d bytes", pid, pseudocodeFileName, sizeBytes);
-                // Intentar crear el proceso en Memoria, reservando marcos y tabla
 
-                t_memoriaProcess* proc = createProcess(pid, sizeBytes, pseudocodeFileName);
+                // Si el proceso ya existe y está suspendido, el Kernel lo está pasando de SUSPENDED_READY a READY: se lo sube desde SWAP
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+
+                if (proc && proc->suspended) {
+                    int swappedIn = swapInProcess(proc, reservationToken);
+                    unpinActiveProcess(proc);
+                    if (!swappedIn)
+                        proc = NULL;
+                } else {
+                    unpinActiveProcess(proc);
+                    // Intentar crear el proceso en Memoria, reservando marcos y tabla
+                    proc = createProcess(pid, sizeBytes, pseudocodeFileName, reservationToken);
+                    if (proc) {
+                        pthread_mutex_lock(&activeProcessesMutex);
+                        dictionary_put(
+                                        activeProcesses,           // diccionario global de Memoria
+                                        string_itoa(pid),          // clave: el PID convertido a cadena
+                                        proc                       // valor: puntero a t_memoriaProcess*
+                                    );
+                        pthread_mutex_unlock(&activeProcessesMutex);
+                    }
+                }
 
 
                 // Enviar la respuesta al Kernel
                 tPackage* resp;
                 if (proc) {
-                    dictionary_put(
-                                    activeProcesses,           // diccionario global de Memoria
-                                    string_itoa(pid),          // clave: el PID convertido a cadena
-                                    proc                       // valor: puntero a t_memoriaProcess*
-                                );
                     // Si tuvo éxito, enviamos OK junto al PID
                     resp = createPackage(MEMORY_TO_KERNEL_PROCESS_LOAD_OK);
                     log_info(memoriaLog, "## (%d) - Proceso cargado en memoria con éxito", pid);
                 } else {
+                    // Si la carga falló, la reserva (si quedó sin usar) ya no sirve
+                    if (reservationToken >= 0)
+                        releaseReservation(reservationToken);
                     // Si no hay espacio, enviamos FAIL junto al PID
                     resp = createPackage(MEMORY_TO_KERNEL_PROCESS_LOAD_FAIL);
                     log_error(memoriaLog,"## (%d) - Falló carga en memoria (espacio insuficiente)", pid);
@@ -435,30 +569,33 @@ void* serverThreadForKernel(void* voidPointerConnectionSocket){
                 log_info(memoriaLog, "## (%d) - REMOVE_PROC recibido", pid);
                 
                 char* pidKey = string_itoa(pid);
-                t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
+                t_memoriaProcess* proc = pinActiveProcess(pid);
 
                 tPackage* resp;
+                int confirmedCpus = 0;
                 if (proc) {
+                    releaseReservationOfPid(pid);
+
+                    // Antes de liberar sus marcos, las CPUs bajan sus páginas modificadas y se olvidan de sus traducciones
+                    confirmedCpus = tlbShootdown(pid, 0, proc->numPages);
+
                     log_info(memoriaLog,
-                             "## PID: <%d> Proceso Destruido - Métricas Acc.T.Pag: <%d>; Inst. Sol.: <%d>; SWAP IN: <%d>; SWAP OUT: <%d>; Lec.Mem.: <%d>; Esc.Mem. <%d>",
+                             "## PID: <%d> Proceso Destruido - Métricas Acc.T.Pag: <%lu>; Inst. Sol.: <%lu>; SWAP IN: <%lu>; SWAP OUT: <%lu>; Lec.Mem.: <%lu>; Esc.Mem. <%lu>",
                              proc->pid,
-                             proc->accesos_a_tabla_paginas,
-                             proc->instructionCount,
-                             proc->subidas_desde_swap,
-                             proc->bajadas_a_swap,
-                             proc->lecturas_en_memoria,
-                             proc->escrituras_en_memoria);
-
-                    // Liberar marcos en bitmap
-                    for (int i = 0; i < proc->numPages; i++) {
-                        bitarray_clean_bit(frameBitmap, proc->frames[i]);
-                    }
-                    // Liberar estructura
-                    free(proc->frames);
-                    free(proc);
-
-                    // Quitar del diccionario
+                             (unsigned long)metricGet(&proc->metrics.pageTableAccesses),
+                             (unsigned long)metricGet(&proc->metrics.instructionFetches),
+                             (unsigned long)metricGet(&proc->metrics.swapIns),
+                             (unsigned long)metricGet(&proc->metrics.swapOuts),
+                             (unsigned long)metricGet(&proc->metrics.reads),
+                             (unsigned long)metricGet(&proc->metrics.writes));
+
+                    // Quitar del diccionario (ya no se lo puede fijar), esperar a los pedidos que lo estén usando,
+                    // y liberar sus marcos (o su SWAP) y su arena
+                    pthread_mutex_lock(&activeProcessesMutex);
                     dictionary_remove(activeProcesses, pidKey);
+                    pthread_mutex_unlock(&activeProcessesMutex);
+                    waitForOtherPins(proc);
+                    destroyMemoriaProcess(proc);
 
                     // Responder OK
                     resp = createPackage(MEMORY_TO_KERNEL_PROCESS_REMOVED);
@@ -470,8 +607,9 @@ void* serverThreadForKernel(void* voidPointerConnectionSocket){
                     log_error(memoriaLog, "## (%d) - REMOVE_PROC fallo: PID no encontrado", pid);
                 }
 
-                //Enviar respuesta al Kernel
+                //Enviar respuesta al Kernel, con cuántas CPUs confirmaron el shootdown
                 addToPackage(resp, &pid, sizeof(uint32_t));
+                addToPackage(resp, &confirmedCpus, sizeof(uint32_t));
                 sendPackage(resp, connectionSocket);
                 // destroyPackage(resp);
 
@@ -482,6 +620,97 @@ void* serverThreadForKernel(void* voidPointerConnectionSocket){
 
 
 
+            case KERNEL_TO_MEMORY_RESERVE_SPACE: {
+                // RESERVE: en un solo mensaje vienen [estricto] y luego pares [pid | tamaño] de los procesos encolados.
+                // Se reserva en orden, y si es estricto (FIFO) se corta en el primero que no entra para no adelantar a nadie.
+                // Se responde con el espacio libre que queda y un par [pid | token] por cada proceso (token -1 si no entró):
+                int strict = extractIntElementFromList(list, 0);
+                int requests = (list_size(list) - 1) / 2;
+
+                tPackage* resp = createPackage(MEMORY_TO_KERNEL_RESERVATION_RESULT);
+                int tokens[requests > 0 ? requests : 1];
+                int pids[requests > 0 ? requests : 1];
+                int rejected = 0;
+
+                for (int i = 0; i < requests; i++) {
+                    pids[i] = extractIntElementFromList(list, 1 + 2 * i);
+                    int sizeBytes = extractIntElementFromList(list, 2 + 2 * i);
+                    tokens[i] = (strict && rejected) ? -1 : createReservation(pids[i], sizeBytes);
+                    if (tokens[i] < 0)
+                        rejected = 1;
+                }
+
+                int freeSpace = getFreeMemoryBytes();
+                addToPackage(resp, &freeSpace, sizeof(int));
+                for (int i = 0; i < requests; i++) {
+                    addToPackage(resp, &pids[i], sizeof(int));
+                    addToPackage(resp, &tokens[i], sizeof(int));
+                }
+                sendPackage(resp, connectionSocket);
+                log_info(memoriaLog, "Reservas procesadas: %d pedidas, espacio libre restante: %d bytes", requests, freeSpace);
+                break;
+            }
+
+            case MEMORIA_STATS:
+                sendStatsResponse(connectionSocket, list);
+                break;
+
+            case KERNEL_TO_MEMORY_RELEASE_RESERVATION: {
+                int token = extractIntElementFromList(list, 0);
+                releaseReservation(token);
+                break;
+            }
+
+            case KERNEL_TO_MEMORY_DUMP_REQUEST: {
+                // DUMP_MEMORY: la primera vez se escribe la imagen completa, después solo las páginas modificadas
+                log_info(memoriaLog, "Aplicando retardo de memoria para KERNEL_TO_MEMORY_DUMP_REQUEST...");
+                simulatedSleepMs(getMemoriaConfig()->RETARDO_MEMORIA);
+                int pid = extractIntElementFromList(list, 0);
+                log_info(memoriaLog, "## (%d) - Memory Dump solicitado", pid);
+
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+                int dumped = proc && dumpProcess(proc);
+                unpinActiveProcess(proc);
+
+                tPackage* resp;
+                if (dumped) {
+                    resp = createPackage(MEMORY_TO_KERNEL_DUMP_COMPLETED);
+                } else {
+                    resp = createPackage(MEMORY_TO_KERNEL_DUMP_FAIL);
+                    log_error(memoriaLog, "## (%d) - Falló el Memory Dump", pid);
+                }
+
+                addToPackage(resp, &pid, sizeof(uint32_t));
+                sendPackage(resp, connectionSocket);
+                break;
+            }
+
+            case KERNEL_TO_MEMORY_REQUEST_TO_SUSPEND_PROCESS: {
+                // SUSPEND: el proceso pasó a SUSPENDED_BLOCKED, se bajan sus páginas a SWAP y se liberan sus marcos
+                int pid = extractIntElementFromList(list, 0);
+                log_info(memoriaLog, "## (%d) - SUSPEND recibido", pid);
+
+                t_memoriaProcess* proc = pinActiveProcess(pid);
+
+                int confirmedCpus = 0;
+                if (!proc)
+                    log_error(memoriaLog, "## (%d) - SUSPEND fallo: PID no encontrado", pid);
+                else if (!proc->suspended) {
+                    releaseReservationOfPid(pid);
+                    // Las páginas modificadas que estén en las CPUs tienen que llegar antes de que se copien los marcos a SWAP
+                    confirmedCpus = tlbShootdown(pid, 0, proc->numPages);
+                    waitForOtherPins(proc);
+                    swapOutProcess(proc);
+                }
+                unpinActiveProcess(proc);
+
+                tPackage* resp = createPackage(MEMORY_TO_KERNEL_PROCESS_SUSPENDED);
+                addToPackage(resp, &pid, sizeof(uint32_t));
+                addToPackage(resp, &confirmedCpus, sizeof(uint32_t));
+                sendPackage(resp, connectionSocket);
+                break;
+            }
+
             default:
                 log_warning(memoriaLog, "Código inesperado de Kernel: %d", package->operationCode);
                 break;
@@ -521,8 +750,13 @@ void initMemory(void) {
     size_t pageSize   = getMemoriaConfig()->TAM_PAGINA;
     size_t frameCount = totalBytes / pageSize;
     size_t bitmapBytes = (frameCount + 7) / 8;
-    void* buffer = malloc(bitmapBytes);
+    void* buffer = calloc(bitmapBytes, 1); // todos los marcos arrancan libres
     frameBitmap = bitarray_create_with_mode(buffer, frameCount, MSB_FIRST);
+    framePages = malloc(sizeof(int) * frameCount);
+    for (size_t i = 0; i < frameCount; i++)
+        framePages[i] = -1;
+    freeFrameCount = frameCount;
+    nextFreeFrameHint = 0;
     log_info(memoriaLog, "Bitmap inicializado: %zu marcos", frameCount);
 }
 
@@ -561,92 +795,244 @@ char* read_file(const char* path) {
 
 
 
-t_memoriaProcess* createProcess(int pid, int sizeBytes, const char* pseudocodeFileName) {
-    int pageSize = getMemoriaConfig()->TAM_PAGINA;
-    int entriesPerTable = getMemoriaConfig()->ENTRADAS_POR_TABLA;
-    int levels = getMemoriaConfig()->CANTIDAD_NIVELES;
-    int pagesNeeded = (sizeBytes > 0) ? (int)ceil((double)sizeBytes / pageSize) : 1;
-    if (sizeBytes == 0) pagesNeeded = 0;
+// Reserva count marcos libres en el bitmap y los devuelve (en orden) en framesOut, que luego hay que liberar con free.
+// Retorna 1 si pudo reservarlos todos, o 0 sin tocar el bitmap si no hay suficientes marcos libres.
+// La cantidad de marcos libres se lleva en freeFrameCount, así que decidir si hay espacio no recorre el bitmap,
+// y la búsqueda arranca desde el último marco asignado (next-fit) para no re-escanear los marcos ocupados del principio:
+int reserveFrames(int count, int** framesOut) {
+    int totalFrames = getMemoriaConfig()->TAM_MEMORIA / getMemoriaConfig()->TAM_PAGINA;
 
-    int freeCount = 0;
-    for (int i = 0; i < (getMemoriaConfig()->TAM_MEMORIA / pageSize); i++) {
-        if (!bitarray_test_bit(frameBitmap, i)) freeCount++;
-    }
-    if (freeCount < pagesNeeded) {
-        log_error(memoriaLog, "No hay espacio para pid=%d: necesita %d páginas, libres %d", pid, pagesNeeded, freeCount);
-        return NULL;
+    pthread_mutex_lock(&frameMutex);
+    if (freeFrameCount < count) {
+        pthread_mutex_unlock(&frameMutex);
+        return 0;
     }
 
-    int* frames = malloc(sizeof(int) * pagesNeeded);
+    int* frames = malloc(sizeof(int) * (count > 0 ? count : 1));
     int reserved = 0;
-    for (int i = 0; i < (getMemoriaConfig()->TAM_MEMORIA / pageSize) && reserved < pagesNeeded; i++) {
+    for (int scanned = 0; scanned < totalFrames && reserved < count; scanned++) {
+        int i = (nextFreeFrameHint + scanned) % totalFrames;
         if (!bitarray_test_bit(frameBitmap, i)) {
             bitarray_set_bit(frameBitmap, i);
             frames[reserved++] = i;
         }
     }
+    freeFrameCount -= reserved;
+    if (reserved > 0)
+        nextFreeFrameHint = (frames[reserved - 1] + 1) % totalFrames;
+    pthread_mutex_unlock(&frameMutex);
 
-    t_memoriaProcess* proc = calloc(1, sizeof(t_memoriaProcess));
-    proc->pid = pid;
-    proc->numPages = pagesNeeded;
-    proc->levels = levels;
-    proc->entriesPerTable = entriesPerTable;
-    proc->frames = frames;
-    // Inicializar  métricas
-    proc->accesos_a_tabla_paginas = 0;
-    proc->lecturas_en_memoria = 0;
-    proc->escrituras_en_memoria = 0;
-    proc->bajadas_a_swap = 0;
-    proc->subidas_desde_swap = 0;
+    *framesOut = frames;
+    return 1;
+}
 
+// Libera un tramo de marcos consecutivos: los bytes completos del bitmap se limpian de a 8 marcos con memset,
+// y solo los bordes del tramo se limpian bit por bit:
+static void releaseFrameRun(int first, int length) {
+    int end = first + length;
+    int frame = first;
+
+    while (frame < end && frame % 8 != 0)
+        bitarray_clean_bit(frameBitmap, frame++);
+    int wholeBytes = (end - frame) / 8;
+    if (wholeBytes > 0) {
+        memset(frameBitmap->bitarray + frame / 8, 0, wholeBytes);
+        frame += wholeBytes * 8;
+    }
+    while (frame < end)
+        bitarray_clean_bit(frameBitmap, frame++);
 
+    // -1 en todos los bytes de un int es -1, así que el mapa marco → página también se limpia de una vez:
+    memset(framePages + first, 0xFF, sizeof(int) * length);
+}
 
-    if (levels > 0) {
-        size_t root_table_size = (levels == 1) ? sizeof(int) : sizeof(void*);
-        proc->pageTables = calloc(entriesPerTable, root_table_size);
-    } else {
-        proc->pageTables = NULL;
+// Marca como libres en el bitmap los marcos pasados (no libera el array).
+// Como reserveFrames asigna marcos consecutivos siempre que puede, se devuelven por tramos y no de a uno:
+void releaseFrames(int* frames, int count) {
+    pthread_mutex_lock(&frameMutex);
+    int i = 0;
+    while (i < count) {
+        int runLength = 1;
+        while (i + runLength < count && frames[i + runLength] == frames[i] + runLength)
+            runLength++;
+        releaseFrameRun(frames[i], runLength);
+        i += runLength;
     }
+    freeFrameCount += count;
+    pthread_mutex_unlock(&frameMutex);
+}
 
-    for (int p = 0; p < pagesNeeded; p++) {
-        int frame_to_assign = frames[p];
-        int page_number_logic = p;
-        void* current_table = proc->pageTables;
+// Retorna el espacio libre real en bytes (los marcos reservados para un proceso que todavía no se cargó ya no cuentan como libres):
+int getFreeMemoryBytes(void) {
+    pthread_mutex_lock(&frameMutex);
+    int freeBytes = freeFrameCount * getMemoriaConfig()->TAM_PAGINA;
+    pthread_mutex_unlock(&frameMutex);
+    return freeBytes;
+}
 
-        for (int lvl = 1; lvl <= levels; lvl++) {
-            int entries_in_lower_levels = (int)pow(entriesPerTable, levels - lvl);
-            int index = floor(page_number_logic / entries_in_lower_levels);
-            
-            if (lvl < levels) {
-                void** sub_table_pointers = (void**)current_table;
-                if (sub_table_pointers[index] == NULL) {
-                    size_t next_table_size = ((lvl + 1) == levels) ? sizeof(int) : sizeof(void*);
-                    sub_table_pointers[index] = calloc(entriesPerTable, next_table_size);
-                }
-                current_table = sub_table_pointers[index];
-            } else {
-                ((int*)current_table)[index] = frame_to_assign;
-            }
-            page_number_logic %= entries_in_lower_levels;
+// Deja la entrada de último nivel de la página en -1 (sin marco), como la lee una CPU que la traduce con el proceso en SWAP.
+// No crea tablas: si la página nunca se mapeó no hay nada que borrar:
+void unmapPage(t_memoriaProcess* proc, int page) {
+    int page_number_logic = page;
+    void* current_table = proc->pageTables;
+
+    for (int lvl = 1; lvl <= proc->levels && current_table; lvl++) {
+        int entries_in_lower_levels = (int)pow(proc->entriesPerTable, proc->levels - lvl);
+        int index = page_number_logic / entries_in_lower_levels;
+
+        if (lvl < proc->levels)
+            current_table = ((void**)current_table)[index];
+        else
+            ((int*)current_table)[index] = -1;
+        page_number_logic %= entries_in_lower_levels;
+    }
+}
+
+// Reserva una tabla de páginas en la arena del proceso. Las de último nivel arrancan con todas sus entradas en -1 (página sin marco),
+// así una página fuera del proceso no se traduce al marco 0, que es de otro; las intermedias arrancan en NULL:
+static void* allocPageTable(t_memoriaArena* arena, int entriesPerTable, bool lastLevel) {
+    if (!lastLevel)
+        return arenaAlloc(arena, entriesPerTable * sizeof(void*));
+    int* table = arenaAlloc(arena, entriesPerTable * sizeof(int));
+    for (int i = 0; i < entriesPerTable; i++)
+        table[i] = -1;
+    return table;
+}
+
+// Recorre la tabla de páginas multinivel del proceso para la página indicada, creando las tablas intermedias que falten,
+// y escribe el marco en la entrada del último nivel:
+void mapPageToFrame(t_memoriaProcess* proc, int page, int frame) {
+    int page_number_logic = page;
+    void* current_table = proc->pageTables;
+
+    for (int lvl = 1; lvl <= proc->levels; lvl++) {
+        int entries_in_lower_levels = (int)pow(proc->entriesPerTable, proc->levels - lvl);
+        int index = floor(page_number_logic / entries_in_lower_levels);
+
+        if (lvl < proc->levels) {
+            void** sub_table_pointers = (void**)current_table;
+            if (sub_table_pointers[index] == NULL)
+                sub_table_pointers[index] = allocPageTable(proc->arena, proc->entriesPerTable, (lvl + 1) == proc->levels);
+            current_table = sub_table_pointers[index];
+        } else {
+            ((int*)current_table)[index] = frame;
         }
+        page_number_logic %= entries_in_lower_levels;
+    }
+    framePages[frame] = page;
+}
+
+// Las imágenes de instrucciones se numeran desde 1 (0 es la instrucción EXIT que se manda para un PC fuera del proceso):
+static atomic_uint nextInstructionImageId = 1;
+
+// Estima cuánto va a ocupar el proceso en su arena, para que normalmente entre todo en un solo bloque:
+// la estructura, la lista de marcos, el bitmap de páginas sucias, las tablas de páginas de cada nivel
+// (las páginas son consecutivas desde la 0, así que en cada nivel hacen falta ceil(páginas / páginas que cubre una tabla) tablas),
+// el texto del pseudocódigo y los punteros a cada instrucción:
+static size_t estimateProcessArenaSize(int pagesNeeded, int levels, int entriesPerTable, size_t fileSize, int lineCount) {
+    size_t bytes = sizeof(t_memoriaProcess) + sizeof(int) * pagesNeeded + (pagesNeeded + 7) / 8 + 1;
+
+    for (int lvl = 1; lvl <= levels; lvl++) {
+        double pagesPerTable = pow(entriesPerTable, levels - lvl + 1);
+        int tables = (lvl == 1) ? 1 : (int)ceil(pagesNeeded / pagesPerTable);
+        size_t entrySize = (lvl == levels) ? sizeof(int) : sizeof(void*);
+        bytes += tables * (entriesPerTable * entrySize + 16);
     }
 
+    bytes += fileSize + 1 + sizeof(char*) * (lineCount + 1);
+    return bytes + 16 * 8; // margen por la alineación de cada bloque pedido
+}
+
+t_memoriaProcess* createProcess(int pid, int sizeBytes, const char* pseudocodeFileName, int reservationToken) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    int entriesPerTable = getMemoriaConfig()->ENTRADAS_POR_TABLA;
+    int levels = getMemoriaConfig()->CANTIDAD_NIVELES;
+    int pagesNeeded = (sizeBytes > 0) ? (int)ceil((double)sizeBytes / pageSize) : 1;
+    if (sizeBytes == 0) pagesNeeded = 0;
+
+    // Se lee primero el pseudocódigo, así si no existe no hay que deshacer nada
     const char* basePath = getMemoriaConfig()->PATH_INSTRUCCIONES;
     char* fullPath = string_from_format("%s%s", basePath, pseudocodeFileName);
     char* fileContent = read_file(fullPath);
     free(fullPath);
 
     if (!fileContent) {
-        // ... (Rollback)
+        log_error(memoriaLog, "No se pudo leer el pseudocódigo '%s' de pid=%d", pseudocodeFileName, pid);
+        return NULL;
+    }
+
+    // Si el Kernel reservó espacio para este proceso, se usan esos marcos (commit de la reserva)
+    int* frames;
+    if (!takeReservedFrames(reservationToken, pid, pagesNeeded, &frames) && !reserveFrames(pagesNeeded, &frames)) {
+        log_error(memoriaLog, "No hay espacio para pid=%d: necesita %d páginas", pid, pagesNeeded);
+        free(fileContent);
         return NULL;
     }
-    proc->instructions = string_split(fileContent, "\n");
+
+    size_t fileSize = strlen(fileContent);
+    int lineCount = 1;
+    for (size_t i = 0; i < fileSize; i++) {
+        if (fileContent[i] == '\n')
+            lineCount++;
+    }
+
+    t_memoriaArena* arena = arenaCreate(estimateProcessArenaSize(pagesNeeded, levels, entriesPerTable, fileSize, lineCount));
+    t_memoriaProcess* proc = arenaAlloc(arena, sizeof(t_memoriaProcess));
+    proc->arena = arena;
+    proc->pid = pid;
+    proc->numPages = pagesNeeded;
+    proc->levels = levels;
+    proc->entriesPerTable = entriesPerTable;
+    proc->frames = arenaAlloc(arena, sizeof(int) * (pagesNeeded > 0 ? pagesNeeded : 1));
+    memcpy(proc->frames, frames, sizeof(int) * pagesNeeded);
+    free(frames);
+    // Inicializar  métricas
+    initProcessMetrics(&proc->metrics);
+    proc->suspended = 0;
+    proc->pins = 0;
+    proc->dumpSequence = 0;
+    proc->dirtyPages = bitarray_create_with_mode(arenaAlloc(arena, (pagesNeeded + 7) / 8 + 1), pagesNeeded, MSB_FIRST);
+
+    if (levels > 0) {
+        proc->pageTables = allocPageTable(arena, entriesPerTable, levels == 1);
+    } else {
+        proc->pageTables = NULL;
+    }
+
+    for (int p = 0; p < pagesNeeded; p++) {
+        mapPageToFrame(proc, p, proc->frames[p]);
+    }
+
+    // Las instrucciones apuntan directo al texto del pseudocódigo copiado en la arena, cortado en cada salto de línea:
+    char* text = arenaAlloc(arena, fileSize + 1);
+    memcpy(text, fileContent, fileSize + 1);
     free(fileContent);
 
+    proc->instructions = arenaAlloc(arena, sizeof(char*) * (lineCount + 1));
     int count = 0;
-    while (proc->instructions[count]) count++;
+    proc->instructions[count++] = text;
+    for (char* c = text; *c; c++) {
+        if (*c == '\n') {
+            *c = '\0';
+            proc->instructions[count++] = c + 1;
+        }
+    }
+    proc->instructions[count] = NULL;
     proc->instructionCount = count;
+    proc->instructionImageId = atomic_fetch_add(&nextInstructionImageId, 1);
 
-    log_info(memoriaLog,"PID %d: %d niveles, %d entradas c/u, %d páginas, %d instrucciones",pid, levels, entriesPerTable, pagesNeeded, count);
+    log_info(memoriaLog,"PID %d: %d niveles, %d entradas c/u, %d páginas, %d instrucciones (arena de %zu bytes)",pid, levels, entriesPerTable, pagesNeeded, count, arena->totalBytes);
     return proc;
 }
+
+// Destruye un proceso que ya se sacó de activeProcesses: sus marcos vuelven al bitmap por tramos (o se descarta su SWAP si estaba suspendido),
+// y todo lo demás (tablas de páginas, lista de marcos, instrucciones, la estructura misma) se libera de una vez con su arena:
+void destroyMemoriaProcess(t_memoriaProcess* proc) {
+    if (proc->suspended)
+        removeProcessFromSwap(proc->pid);
+    else
+        releaseFrames(proc->frames, proc->numPages);
+
+    bitarray_destroy(proc->dirtyPages);
+    arenaDestroy(proc->arena);
+}
@@ -2,6 +2,8 @@
 #define MEMORIA_SERVER_H
 #include <commons/bitarray.h>           // para t_bitarray y bitarray_*
 #include <commons/collections/dictionary.h> // para t_dictionary
+#include "memoriaArena.h"
+#include "memoriaStats.h"
 
 
 
@@ -15,7 +17,9 @@ void* serverThreadForKernel(void* voidPointerConnectionSocket);
 
 void initMemory(void);
 
+// Todo lo que apunta esta estructura (y la estructura misma) vive en la arena del proceso, salvo el t_bitarray de dirtyPages:
 typedef struct {
+    t_memoriaArena* arena;
     int pid;
     int numPages;
     int* frames;
@@ -24,16 +28,31 @@ typedef struct {
     void* pageTables; 
     char** instructions;
     int instructionCount;
-    int accesos_a_tabla_paginas;
-    int lecturas_en_memoria;
-    int escrituras_en_memoria;
-    // metricas para  SWAP
-    int bajadas_a_swap; 
-    int subidas_desde_swap;
+    // Identifica esta imagen de instrucciones (único entre todos los procesos creados); viaja con cada instrucción para que la CPU
+    // sepa si las que tiene decodificadas en su caché siguen siendo válidas:
+    uint32_t instructionImageId;
+    // Métricas (accesos a tabla de páginas, instrucciones pedidas, lecturas/escrituras, SWAP), se actualizan de forma atómica
+    tMemoriaProcessMetrics metrics;
+    int suspended; // 1 si sus páginas están en SWAP y no tiene marcos asignados
+    int pins;      // pedidos que lo están usando en este momento (ver pinActiveProcess), protegido por activeProcessesMutex
+    // Para los dumps incrementales: páginas escritas desde el último dump, y cuántos dumps se hicieron
+    t_bitarray* dirtyPages;
+    int dumpSequence;
 
 } t_memoriaProcess;
 
-t_memoriaProcess* createProcess(int pid, int sizeBytes, const char* pseudocodeFileName);
+t_memoriaProcess* createProcess(int pid, int sizeBytes, const char* pseudocodeFileName, int reservationToken);
+void destroyMemoriaProcess(t_memoriaProcess* proc);
+
+int reserveFrames(int count, int** framesOut);
+void releaseFrames(int* frames, int count);
+int getFreeMemoryBytes(void);
+void mapPageToFrame(t_memoriaProcess* proc, int page, int frame);
+void unmapPage(t_memoriaProcess* proc, int page);
+
+t_memoriaProcess* pinActiveProcess(int pid);
+void unpinActiveProcess(t_memoriaProcess* proc);
+void waitForOtherPins(t_memoriaProcess* proc);
 
 int translateAddress(t_memoriaProcess* proc, int dl);
 
@@ -42,10 +61,11 @@ int translateAddress(t_memoriaProcess* proc, int dl);
 extern int finishServer;
 extern int listeningSocket;
 
-#define MOCK_FREE_MEMORY 1024 // ! luego del mock borrar!
-
 extern void*          memory;           // bloque de RAM simulada
 extern t_bitarray*    frameBitmap;      // bitmap de marcos
+extern int*           framePages;       // marco → página lógica que lo usa (-1 si está libre)
+extern int            freeFrameCount;   // cantidad exacta de marcos libres
+extern pthread_mutex_t frameMutex;
 extern t_dictionary* activeProcesses;  // contendra los procesos activos, al ser un diccionario puedo buscar por pid 
 
 
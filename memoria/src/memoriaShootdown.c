@@ -0,0 +1,113 @@
+#include "memoria.h"
+#include "memoriaShootdown.h"
+#include <errno.h>
+
+// CPU conectada por su conexión de interrupt. ackedId es el id del último shootdown que confirmó:
+typedef struct {
+    int connectionSocket;
+    uint32_t ackedId;
+} tShootdownCpu;
+
+static t_list* shootdownCpus; // lista de tShootdownCpu*
+static uint32_t lastShootdownId;
+static pthread_mutex_t shootdownCpusMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t shootdownAcked = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t shootdownMutex = PTHREAD_MUTEX_INITIALIZER; // un shootdown por vez
+
+// Lo llama el hilo de la conexión de interrupt de cada CPU al arrancar:
+void shootdownRegisterCpu(int connectionSocket) {
+    tShootdownCpu* cpu = malloc(sizeof(tShootdownCpu));
+    cpu->connectionSocket = connectionSocket;
+
+    pthread_mutex_lock(&shootdownCpusMutex);
+    if (!shootdownCpus)
+        shootdownCpus = list_create();
+    cpu->ackedId = lastShootdownId; // no le debe nada a los shootdowns anteriores
+    list_add(shootdownCpus, cpu);
+    pthread_mutex_unlock(&shootdownCpusMutex);
+}
+
+// Posición de la CPU con esa conexión en la lista, o -1 si no está (se llama con shootdownCpusMutex tomado):
+static int findCpuIndex(int connectionSocket) {
+    for (int i = 0; shootdownCpus && i < list_size(shootdownCpus); i++)
+        if (((tShootdownCpu*)list_get(shootdownCpus, i))->connectionSocket == connectionSocket)
+            return i;
+    return -1;
+}
+
+// Una CPU que se desconecta ya no tiene nada que invalidar: si había un shootdown esperándola, deja de esperarla:
+void shootdownUnregisterCpu(int connectionSocket) {
+    pthread_mutex_lock(&shootdownCpusMutex);
+    int index = findCpuIndex(connectionSocket);
+    tShootdownCpu* cpu = index >= 0 ? list_remove(shootdownCpus, index) : NULL;
+    pthread_cond_broadcast(&shootdownAcked);
+    pthread_mutex_unlock(&shootdownCpusMutex);
+    free(cpu);
+}
+
+void shootdownAcknowledge(int connectionSocket, uint32_t id) {
+    pthread_mutex_lock(&shootdownCpusMutex);
+    int index = findCpuIndex(connectionSocket);
+    tShootdownCpu* cpu = index >= 0 ? list_get(shootdownCpus, index) : NULL;
+    if (cpu && id > cpu->ackedId)
+        cpu->ackedId = id;
+    pthread_cond_broadcast(&shootdownAcked);
+    pthread_mutex_unlock(&shootdownCpusMutex);
+}
+
+static int pendingAcks(uint32_t id) {
+    int pending = 0;
+    for (int i = 0; i < list_size(shootdownCpus); i++)
+        if (((tShootdownCpu*)list_get(shootdownCpus, i))->ackedId < id)
+            pending++;
+    return pending;
+}
+
+// Manda la invalidación de las páginas [first, first + count) del pid a todas las CPUs conectadas y espera que cada una confirme
+// o se desconecte. No se llama con ningún lock de Memoria tomado: para confirmar, una CPU puede tener que escribir antes sus páginas modificadas.
+// Retorna cuántas CPUs confirmaron:
+int tlbShootdown(int pid, uint32_t first, uint32_t count) {
+    pthread_mutex_lock(&shootdownMutex);
+    pthread_mutex_lock(&shootdownCpusMutex);
+    if (!shootdownCpus || list_is_empty(shootdownCpus)) {
+        pthread_mutex_unlock(&shootdownCpusMutex);
+        pthread_mutex_unlock(&shootdownMutex);
+        return 0;
+    }
+
+    uint32_t id = ++lastShootdownId;
+    int sent = list_size(shootdownCpus);
+    for (int i = 0; i < sent; i++) {
+        tShootdownCpu* cpu = list_get(shootdownCpus, i);
+        tPackage* request = createPackage(MEMORIA_TO_CPU_SHOOTDOWN);
+        addToPackage(request, &id, sizeof(uint32_t));
+        addToPackage(request, &pid, sizeof(uint32_t));
+        addToPackage(request, &first, sizeof(uint32_t));
+        addToPackage(request, &count, sizeof(uint32_t));
+        sendPackage(request, cpu->connectionSocket);
+    }
+
+    int pending;
+    int waitedMs = 0;
+    while ((pending = pendingAcks(id)) > 0) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += SHOOTDOWN_WARNING_MS / 1000;
+        deadline.tv_nsec += (SHOOTDOWN_WARNING_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        if (pthread_cond_timedwait(&shootdownAcked, &shootdownCpusMutex, &deadline) == ETIMEDOUT) {
+            waitedMs += SHOOTDOWN_WARNING_MS;
+            log_warning(memoriaLog, "## (%d) - Shootdown %u: %d CPUs todavía no confirmaron después de %d ms", pid, id, pendingAcks(id), waitedMs);
+        }
+    }
+    // Las que se desconectaron mientras tanto ya no están en la lista
+    int confirmed = list_size(shootdownCpus);
+    pthread_mutex_unlock(&shootdownCpusMutex);
+    pthread_mutex_unlock(&shootdownMutex);
+
+    log_info(memoriaLog, "## (%d) - Shootdown %u de las páginas [%u, %u) confirmado por %d de %d CPUs", pid, id, first, first + count, confirmed, sent);
+    return confirmed;
+}
@@ -0,0 +1,21 @@
+#ifndef MEMORIA_SHOOTDOWN_H
+#define MEMORIA_SHOOTDOWN_H
+
+#include <stdint.h>
+#include <utils.h>
+
+// TLB shootdown: antes de que un proceso deje sus marcos (se baja a SWAP o se elimina), Memoria les avisa a todas las CPUs conectadas
+// que invaliden lo que tengan de ese proceso en la TLB y en la Caché de Páginas (bajando antes las páginas modificadas) y espera
+// que cada una confirme. Así las CPUs pueden conservar traducciones y páginas entre cambios de contexto sin que queden viejas.
+// El aviso va por la conexión de interrupt de cada CPU, que solo usa Memoria para esto:
+
+// Cada cuánto se avisa en el log que hay CPUs que todavía no confirmaron. No se sigue sin ellas: se las espera hasta que
+// confirmen o se desconecten (al desconectarse se las da de baja), porque una CPU atrasada puede bajar páginas a marcos ya liberados:
+#define SHOOTDOWN_WARNING_MS 2000
+
+void shootdownRegisterCpu(int connectionSocket);
+void shootdownUnregisterCpu(int connectionSocket);
+void shootdownAcknowledge(int connectionSocket, uint32_t id);
+int tlbShootdown(int pid, uint32_t first, uint32_t count);
+
+#endif
@@ -0,0 +1,89 @@
+#include "memoria.h"
+#include "memoriaSoak.h"
+
+// Benchmark de resistencia: crea y destruye procesos sin parar (con algunos pasando por SWAP y escribiendo su memoria),
+// y va midiendo el RSS del proceso Memoria. Si el ciclo de vida de los procesos no pierde memoria, el RSS queda plano
+// después del calentamiento inicial. Uso: ./bin/memoria --soak <ciclos> <pseudocódigo> <tamaño>
+#define SOAK_LIVE_PROCESSES 8
+#define SOAK_CHECKPOINTS 10
+#define SOAK_MAX_RSS_GROWTH_KB 512
+
+static long currentRssKb(void) {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return -1;
+    long totalPages = 0, residentPages = 0;
+    int ok = fscanf(statm, "%ld %ld", &totalPages, &residentPages) == 2;
+    fclose(statm);
+    return ok ? residentPages * (sysconf(_SC_PAGESIZE) / 1024) : -1;
+}
+
+// Ensucia la memoria del proceso para que el swap y el bitmap de páginas sucias trabajen como en un caso real:
+static void touchProcessMemory(t_memoriaProcess* proc, long cycle) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    for (int i = 0; i < proc->numPages; i++) {
+        int physicalAddress = proc->frames[i] * pageSize;
+        memset((char*)memory + physicalAddress, (int)((cycle + i) & 0xFF), pageSize / 2);
+        markDirtyRange(proc, physicalAddress, pageSize / 2);
+    }
+}
+
+// Retorna 0 si el RSS se mantuvo plano, o 1 si creció más de SOAK_MAX_RSS_GROWTH_KB después del calentamiento:
+int runSoakBenchmark(long cycles, const char* pseudocodeFileName, int sizeBytes) {
+    t_log* soakLog = log_create("MEMORIA_SOAK.log", "MEMORIA_SOAK", true, LOG_LEVEL_INFO);
+    t_memoriaProcess* live[SOAK_LIVE_PROCESSES] = { NULL };
+
+    long checkpointEvery = cycles / SOAK_CHECKPOINTS > 0 ? cycles / SOAK_CHECKPOINTS : 1;
+    long warmRssKb = -1;
+    long lastRssKb = currentRssKb();
+    int freeBytesAtStart = getFreeMemoryBytes();
+    long failedCreations = 0;
+
+    log_info(soakLog, "Soak: %ld ciclos, '%s' de %d bytes, %d procesos vivos a la vez, RSS inicial %ld KB",
+             cycles, pseudocodeFileName, sizeBytes, SOAK_LIVE_PROCESSES, lastRssKb);
+
+    for (long cycle = 0; cycle < cycles; cycle++) {
+        int slot = cycle % SOAK_LIVE_PROCESSES;
+        if (live[slot]) {
+            destroyMemoriaProcess(live[slot]);
+            live[slot] = NULL;
+        }
+
+        t_memoriaProcess* proc = createProcess((int)(cycle % 1000000), sizeBytes, pseudocodeFileName, -1);
+        if (!proc) {
+            failedCreations++;
+            continue;
+        }
+        touchProcessMemory(proc, cycle);
+
+        // Uno de cada tres procesos hace un ciclo de suspensión completo:
+        if (cycle % 3 == 0 && swapOutProcess(proc))
+            swapInProcess(proc, -1);
+
+        live[slot] = proc;
+
+        if ((cycle + 1) % checkpointEvery == 0) {
+            lastRssKb = currentRssKb();
+            if (warmRssKb < 0)
+                warmRssKb = lastRssKb;
+            log_info(soakLog, "Soak: %ld/%ld ciclos, RSS %ld KB (%+ld KB desde el calentamiento)",
+                     cycle + 1, cycles, lastRssKb, lastRssKb - warmRssKb);
+        }
+    }
+
+    for (int i = 0; i < SOAK_LIVE_PROCESSES; i++) {
+        if (live[i])
+            destroyMemoriaProcess(live[i]);
+    }
+
+    lastRssKb = currentRssKb();
+    int leakedBytes = freeBytesAtStart - getFreeMemoryBytes();
+    long growthKb = warmRssKb >= 0 ? lastRssKb - warmRssKb : 0;
+    int flat = growthKb <= SOAK_MAX_RSS_GROWTH_KB && leakedBytes == 0;
+
+    log_info(soakLog, "Soak terminado: RSS final %ld KB (%+ld KB desde el calentamiento), %d bytes de memoria de usuario sin liberar, %ld creaciones fallidas -> %s",
+             lastRssKb, growthKb, leakedBytes, failedCreations, flat ? "RSS plano" : "PIERDE MEMORIA");
+
+    log_destroy(soakLog);
+    return flat ? 0 : 1;
+}
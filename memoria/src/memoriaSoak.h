@@ -0,0 +1,6 @@
+#ifndef MEMORIA_SOAK_H
+#define MEMORIA_SOAK_H
+
+int runSoakBenchmark(long cycles, const char* pseudocodeFileName, int sizeBytes);
+
+#endif
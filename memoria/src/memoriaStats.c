@@ -0,0 +1,184 @@
+#include "memoria.h"
+#include "memoriaStats.h"
+#include <errno.h>
+#include <time.h>
+
+// Export de métricas en formato de texto, una métrica por línea: "<nombre>{pid="<pid>"} <valor>".
+// Se puede pedir en cualquier momento con el código MEMORIA_STATS (desde la conexión de CPU o de Kernel),
+// y si STATS_INTERVALO es mayor a 0, un hilo lo escribe periódicamente en STATS_PATH.
+
+pthread_mutex_t activeProcessesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_t exporterThread;
+static int exporterRunning;
+static pthread_mutex_t exporterMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t exporterStop = PTHREAD_COND_INITIALIZER;
+
+void initProcessMetrics(tMemoriaProcessMetrics* metrics) {
+    atomic_init(&metrics->pageTableAccesses, 0);
+    atomic_init(&metrics->instructionFetches, 0);
+    atomic_init(&metrics->reads, 0);
+    atomic_init(&metrics->writes, 0);
+    atomic_init(&metrics->bytesRead, 0);
+    atomic_init(&metrics->bytesWritten, 0);
+    atomic_init(&metrics->swapOuts, 0);
+    atomic_init(&metrics->swapIns, 0);
+    atomic_init(&metrics->pagesSwappedOut, 0);
+    atomic_init(&metrics->pagesSwappedIn, 0);
+}
+
+static void appendProcessStats(char** text, t_memoriaProcess* proc) {
+    tMemoriaProcessMetrics* m = &proc->metrics;
+    string_append_with_format(text,
+        "memoria_process_pages{pid=\"%d\"} %d\n"
+        "memoria_process_suspended{pid=\"%d\"} %d\n"
+        "memoria_process_page_table_accesses{pid=\"%d\"} %lu\n"
+        "memoria_process_instruction_fetches{pid=\"%d\"} %lu\n"
+        "memoria_process_reads{pid=\"%d\"} %lu\n"
+        "memoria_process_writes{pid=\"%d\"} %lu\n"
+        "memoria_process_bytes_read{pid=\"%d\"} %lu\n"
+        "memoria_process_bytes_written{pid=\"%d\"} %lu\n"
+        "memoria_process_swap_outs{pid=\"%d\"} %lu\n"
+        "memoria_process_swap_ins{pid=\"%d\"} %lu\n"
+        "memoria_process_pages_swapped_out{pid=\"%d\"} %lu\n"
+        "memoria_process_pages_swapped_in{pid=\"%d\"} %lu\n",
+        proc->pid, proc->numPages,
+        proc->pid, proc->suspended,
+        proc->pid, (unsigned long)metricGet(&m->pageTableAccesses),
+        proc->pid, (unsigned long)metricGet(&m->instructionFetches),
+        proc->pid, (unsigned long)metricGet(&m->reads),
+        proc->pid, (unsigned long)metricGet(&m->writes),
+        proc->pid, (unsigned long)metricGet(&m->bytesRead),
+        proc->pid, (unsigned long)metricGet(&m->bytesWritten),
+        proc->pid, (unsigned long)metricGet(&m->swapOuts),
+        proc->pid, (unsigned long)metricGet(&m->swapIns),
+        proc->pid, (unsigned long)metricGet(&m->pagesSwappedOut),
+        proc->pid, (unsigned long)metricGet(&m->pagesSwappedIn));
+}
+
+// Arma el texto con las métricas globales y las del proceso pid (o las de todos los procesos si pid es -1):
+char* buildStatsText(int pid) {
+    tSwapMetrics swap;
+    getSwapMetrics(&swap);
+
+    int totalFrames = getMemoriaConfig()->TAM_MEMORIA / getMemoriaConfig()->TAM_PAGINA;
+    char* text = string_from_format(
+        "memoria_frames_total %d\n"
+        "memoria_free_bytes %d\n"
+        "memoria_swap_pages_out %lu\n"
+        "memoria_swap_pages_in %lu\n"
+        "memoria_swap_tier_hits %lu\n"
+        "memoria_swap_tier_misses %lu\n"
+        "memoria_swap_tier_used_bytes %zu\n"
+        "memoria_swap_file_operations %lu\n",
+        totalFrames,
+        getFreeMemoryBytes(),
+        (unsigned long)swap.pagesOut,
+        (unsigned long)swap.pagesIn,
+        (unsigned long)swap.tierHits,
+        (unsigned long)swap.tierMisses,
+        swap.tierUsedBytes,
+        (unsigned long)swap.swapFileOperations);
+
+    pthread_mutex_lock(&activeProcessesMutex);
+    if (pid >= 0) {
+        char* pidKey = string_itoa(pid);
+        t_memoriaProcess* proc = dictionary_get(activeProcesses, pidKey);
+        free(pidKey);
+        if (proc)
+            appendProcessStats(&text, proc);
+    } else {
+        t_list* processes = dictionary_elements(activeProcesses);
+        for (int i = 0; i < list_size(processes); i++)
+            appendProcessStats(&text, list_get(processes, i));
+        list_destroy(processes);
+    }
+    pthread_mutex_unlock(&activeProcessesMutex);
+
+    return text;
+}
+
+// Responde un pedido MEMORIA_STATS: el paquete trae opcionalmente un pid (-1 o nada para todos los procesos),
+// y se contesta con el mismo código de operación y el texto de las métricas:
+void sendStatsResponse(int connectionSocket, t_list* list) {
+    int pid = list_size(list) > 0 ? extractIntElementFromList(list, 0) : -1;
+    char* text = buildStatsText(pid);
+
+    tPackage* response = createPackage(MEMORIA_STATS);
+    addToPackage(response, text, strlen(text) + 1);
+    sendPackage(response, connectionSocket);
+
+    free(text);
+}
+
+// Escribe el export en un archivo temporal y lo renombra, así el que lo lee nunca ve un archivo a medio escribir:
+static void writeStatsFile(void) {
+    char* path = getMemoriaConfig()->STATS_PATH;
+    char* temporaryPath = string_from_format("%s.tmp", path);
+    char* text = buildStatsText(-1);
+
+    FILE* file = fopen(temporaryPath, "w");
+    if (file) {
+        fputs(text, file);
+        fclose(file);
+        if (rename(temporaryPath, path) != 0)
+            log_error(memoriaLog, "No se pudo renombrar el export de métricas a '%s'", path);
+    } else {
+        log_error(memoriaLog, "No se pudo escribir el export de métricas en '%s'", temporaryPath);
+    }
+
+    free(text);
+    free(temporaryPath);
+}
+
+static void* statsExporter(void* unused) {
+    int intervalMs = getMemoriaConfig()->STATS_INTERVALO;
+
+    pthread_mutex_lock(&exporterMutex);
+    while (exporterRunning) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += intervalMs / 1000;
+        deadline.tv_nsec += (long)(intervalMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        if (pthread_cond_timedwait(&exporterStop, &exporterMutex, &deadline) == ETIMEDOUT && exporterRunning) {
+            pthread_mutex_unlock(&exporterMutex);
+            writeStatsFile();
+            pthread_mutex_lock(&exporterMutex);
+        }
+    }
+    pthread_mutex_unlock(&exporterMutex);
+    return NULL;
+}
+
+// Arranca el hilo de export periódico si STATS_INTERVALO es mayor a 0:
+void startStatsExporter(void) {
+    if (getMemoriaConfig()->STATS_INTERVALO <= 0)
+        return;
+
+    exporterRunning = 1;
+    if (pthread_create(&exporterThread, NULL, statsExporter, NULL) != 0) {
+        log_error(memoriaLog, "No se pudo crear el hilo de export de métricas");
+        exporterRunning = 0;
+        return;
+    }
+    log_info(memoriaLog, "Export de métricas cada %d ms en '%s'", getMemoriaConfig()->STATS_INTERVALO, getMemoriaConfig()->STATS_PATH);
+}
+
+// Detiene el hilo de export (lo despierta si estaba esperando) y escribe un último export:
+void stopStatsExporter(void) {
+    pthread_mutex_lock(&exporterMutex);
+    int wasRunning = exporterRunning;
+    exporterRunning = 0;
+    pthread_cond_signal(&exporterStop);
+    pthread_mutex_unlock(&exporterMutex);
+
+    if (wasRunning) {
+        pthread_join(exporterThread, NULL);
+        writeStatsFile();
+    }
+}
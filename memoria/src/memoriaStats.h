@@ -0,0 +1,43 @@
+#ifndef MEMORIA_STATS_H
+#define MEMORIA_STATS_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <commons/collections/list.h>
+
+// Métricas de un proceso. Las incrementan a la vez los hilos de CPU y de Kernel, así que son atómicas,
+// pero relajadas: cada contador es independiente y no ordena ningún otro acceso a memoria.
+typedef struct {
+    atomic_uint_fast64_t pageTableAccesses;
+    atomic_uint_fast64_t instructionFetches;
+    atomic_uint_fast64_t reads;
+    atomic_uint_fast64_t writes;
+    atomic_uint_fast64_t bytesRead;
+    atomic_uint_fast64_t bytesWritten;
+    atomic_uint_fast64_t swapOuts;
+    atomic_uint_fast64_t swapIns;
+    atomic_uint_fast64_t pagesSwappedOut;
+    atomic_uint_fast64_t pagesSwappedIn;
+} tMemoriaProcessMetrics;
+
+static inline void metricAdd(atomic_uint_fast64_t* counter, uint64_t amount) {
+    atomic_fetch_add_explicit(counter, amount, memory_order_relaxed);
+}
+
+static inline uint64_t metricGet(atomic_uint_fast64_t* counter) {
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+// Protege las altas y bajas de activeProcesses contra el export de métricas, que recorre el diccionario:
+extern pthread_mutex_t activeProcessesMutex;
+
+void initProcessMetrics(tMemoriaProcessMetrics* metrics);
+
+char* buildStatsText(int pid);
+void sendStatsResponse(int connectionSocket, t_list* list);
+
+void startStatsExporter(void);
+void stopStatsExporter(void);
+
+#endif
@@ -0,0 +1,312 @@
+#include "memoria.h"
+#include "memoriaSwap.h"
+#include "memoriaLz.h"
+
+// El SWAP tiene dos niveles: un tier comprimido en RAM (con un presupuesto de SWAP_RAM_TAMANIO bytes), y el archivo PATH_SWAPFILE.
+// Las páginas que se bajan a SWAP van primero al tier, y solo se escriben en el archivo cuando el tier ya no tiene lugar.
+// El RETARDO_SWAP se aplica una vez por operación (bajar o subir un proceso) solo si esa operación tuvo que tocar el archivo,
+// y cada operación que se resolvió entera en RAM suma ese retardo a las métricas como tiempo ahorrado.
+static t_dictionary* swappedProcesses; // diccionario PID → t_swappedProcess*
+static FILE* swapFile;
+static t_list* freeSwapSlots;          // slots del swapfile que quedaron libres (int*)
+static int nextSwapSlot;
+static tSwapMetrics swapMetrics;
+static pthread_mutex_t swapMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Crea las estructuras del SWAP y el archivo de swap (lo trunca si ya existía):
+void initSwap(void) {
+    swappedProcesses = dictionary_create();
+    freeSwapSlots = list_create();
+    nextSwapSlot = 0;
+    memset(&swapMetrics, 0, sizeof(tSwapMetrics));
+
+    swapFile = fopen(getMemoriaConfig()->PATH_SWAPFILE, "w+b");
+    if (!swapFile)
+        log_error(memoriaLog, "No se pudo abrir el swapfile '%s', solo se usará el tier en RAM", getMemoriaConfig()->PATH_SWAPFILE);
+
+    log_info(memoriaLog, "SWAP inicializado: tier comprimido de %d bytes, páginas uniformes %s",
+             getMemoriaConfig()->SWAP_RAM_TAMANIO,
+             getMemoriaConfig()->SWAP_RAM_PAGINAS_UNIFORMES ? "habilitadas" : "deshabilitadas");
+}
+
+// Libera las páginas guardadas de un proceso, devolviendo su espacio al tier y sus slots al swapfile:
+static void destroySwappedProcess(void* voidSwapped) {
+    t_swappedProcess* swapped = voidSwapped;
+    for (int i = 0; i < swapped->numPages; i++) {
+        t_swapPage* page = &swapped->pages[i];
+        if (page->location == SWAP_PAGE_COMPRESSED) {
+            swapMetrics.tierUsedBytes -= page->dataSize;
+            free(page->data);
+        } else if (page->location == SWAP_PAGE_FILE) {
+            int* slot = malloc(sizeof(int));
+            *slot = page->fileSlot;
+            list_add(freeSwapSlots, slot);
+        }
+    }
+    free(swapped->pages);
+    free(swapped);
+}
+
+void destroySwap(void) {
+    pthread_mutex_lock(&swapMutex);
+    dictionary_destroy_and_destroy_elements(swappedProcesses, destroySwappedProcess);
+    list_destroy_and_destroy_elements(freeSwapSlots, free);
+    if (swapFile)
+        fclose(swapFile);
+    pthread_mutex_unlock(&swapMutex);
+}
+
+static int isSameFilled(const uint8_t* content, int size) {
+    for (int i = 1; i < size; i++) {
+        if (content[i] != content[0])
+            return 0;
+    }
+    return 1;
+}
+
+// Escribe una página en un slot libre del swapfile, retorna el slot o -1 si falló:
+static int writePageToSwapFile(const void* content, int pageSize) {
+    if (!swapFile)
+        return -1;
+
+    int slot;
+    if (!list_is_empty(freeSwapSlots)) {
+        int* freeSlot = list_remove(freeSwapSlots, 0);
+        slot = *freeSlot;
+        free(freeSlot);
+    } else {
+        slot = nextSwapSlot++;
+    }
+
+    if (fseek(swapFile, (long)slot * pageSize, SEEK_SET) != 0 || fwrite(content, pageSize, 1, swapFile) != 1) {
+        log_error(memoriaLog, "Error escribiendo el slot %d del swapfile", slot);
+        int* freeSlot = malloc(sizeof(int));
+        *freeSlot = slot;
+        list_add(freeSwapSlots, freeSlot);
+        return -1;
+    }
+    fflush(swapFile);
+    return slot;
+}
+
+static int readPageFromSwapFile(int slot, void* content, int pageSize) {
+    if (fseek(swapFile, (long)slot * pageSize, SEEK_SET) != 0 || fread(content, pageSize, 1, swapFile) != 1) {
+        log_error(memoriaLog, "Error leyendo el slot %d del swapfile", slot);
+        return 0;
+    }
+    return 1;
+}
+
+// Aplica el retardo de SWAP si la operación tocó el archivo, o lo cuenta como ahorrado si se resolvió en RAM:
+static void chargeSwapOperation(int usedSwapFile) {
+    if (usedSwapFile) {
+        swapMetrics.swapFileOperations++;
+        simulatedSleepMs(getMemoriaConfig()->RETARDO_SWAP);
+    } else {
+        swapMetrics.savedMilliseconds += getMemoriaConfig()->RETARDO_SWAP;
+    }
+}
+
+// Baja todas las páginas del proceso a SWAP y libera sus marcos. Retorna 1 si pudo, o 0 dejando el proceso como estaba:
+int swapOutProcess(t_memoriaProcess* proc) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+    size_t tierBudget = getMemoriaConfig()->SWAP_RAM_TAMANIO;
+
+    pthread_mutex_lock(&swapMutex);
+
+    t_swappedProcess* swapped = malloc(sizeof(t_swappedProcess));
+    swapped->pid = proc->pid;
+    swapped->numPages = 0;
+    swapped->pages = calloc(proc->numPages > 0 ? proc->numPages : 1, sizeof(t_swapPage));
+
+    // Se comprime con capacidad pageSize - 1 para que lzCompress falle si no se gana nada, y en ese caso se guarda la página cruda:
+    uint8_t* compressed = malloc(pageSize);
+    int usedSwapFile = 0;
+
+    for (int i = 0; i < proc->numPages; i++) {
+        uint8_t* content = (uint8_t*)memory + proc->frames[i] * pageSize;
+        t_swapPage* page = &swapped->pages[i];
+
+        if (getMemoriaConfig()->SWAP_RAM_PAGINAS_UNIFORMES && isSameFilled(content, pageSize)) {
+            page->location = SWAP_PAGE_SAME_FILLED;
+            page->fillByte = content[0];
+            swapMetrics.sameFilledPages++;
+            swapped->numPages++;
+            continue;
+        }
+
+        int compressedSize = lzCompress(content, pageSize, compressed, pageSize - 1);
+        const void* toStore = compressedSize > 0 ? (const void*)compressed : (const void*)content;
+        uint32_t storedSize = compressedSize > 0 ? (uint32_t)compressedSize : (uint32_t)pageSize;
+
+        if (swapMetrics.tierUsedBytes + storedSize <= tierBudget) {
+            page->location = SWAP_PAGE_COMPRESSED;
+            page->data = malloc(storedSize);
+            memcpy(page->data, toStore, storedSize);
+            page->dataSize = storedSize;
+            swapMetrics.tierUsedBytes += storedSize;
+            swapMetrics.rawBytesInTier += pageSize;
+            swapMetrics.storedBytesInTier += storedSize;
+            swapMetrics.compressedPages++;
+        } else {
+            int slot = writePageToSwapFile(content, pageSize);
+            if (slot < 0) {
+                log_error(memoriaLog, "## (%d) - No se pudo bajar el proceso a SWAP", proc->pid);
+                destroySwappedProcess(swapped);
+                free(compressed);
+                pthread_mutex_unlock(&swapMutex);
+                return 0;
+            }
+            page->location = SWAP_PAGE_FILE;
+            page->fileSlot = slot;
+            swapMetrics.filePages++;
+            usedSwapFile = 1;
+        }
+        swapped->numPages++;
+    }
+    free(compressed);
+
+    char* pidKey = string_itoa(proc->pid);
+    dictionary_put(swappedProcesses, pidKey, swapped);
+    free(pidKey);
+
+    swapMetrics.pagesOut += proc->numPages;
+    chargeSwapOperation(usedSwapFile);
+
+    pthread_mutex_unlock(&swapMutex);
+
+    // El array de marcos es de la arena del proceso, así que se conserva y se vuelve a llenar en el swap-in.
+    // La tabla de páginas deja de apuntar a los marcos liberados, que ya pueden ser de otro proceso:
+    for (int i = 0; i < proc->numPages; i++)
+        unmapPage(proc, i);
+    releaseFrames(proc->frames, proc->numPages);
+    proc->suspended = 1;
+    metricAdd(&proc->metrics.swapOuts, 1);
+    metricAdd(&proc->metrics.pagesSwappedOut, proc->numPages);
+
+    log_info(memoriaLog, "## (%d) - Proceso bajado a SWAP: %d páginas%s", proc->pid, proc->numPages, usedSwapFile ? " (usó swapfile)" : "");
+    logSwapMetrics();
+    return 1;
+}
+
+// Sube las páginas del proceso desde SWAP a marcos nuevos (los de la reserva reservationToken, si el Kernel reservó) y actualiza su tabla de páginas.
+// La tabla se actualiza recién cuando todas las páginas se copiaron bien, así si una falla no queda ninguna entrada apuntando a los marcos
+// que se devuelven. Retorna 1 si pudo, o 0 si no hay marcos suficientes o el SWAP está corrupto (el proceso sigue en SWAP):
+int swapInProcess(t_memoriaProcess* proc, int reservationToken) {
+    int pageSize = getMemoriaConfig()->TAM_PAGINA;
+
+    pthread_mutex_lock(&swapMutex);
+
+    char* pidKey = string_itoa(proc->pid);
+    t_swappedProcess* swapped = dictionary_get(swappedProcesses, pidKey);
+
+    if (!swapped) {
+        log_error(memoriaLog, "## (%d) - El proceso no está en SWAP", proc->pid);
+        free(pidKey);
+        pthread_mutex_unlock(&swapMutex);
+        return 0;
+    }
+
+    int* frames;
+    if (!takeReservedFrames(reservationToken, proc->pid, swapped->numPages, &frames) && !reserveFrames(swapped->numPages, &frames)) {
+        log_error(memoriaLog, "## (%d) - No hay marcos libres para subir el proceso desde SWAP", proc->pid);
+        free(pidKey);
+        pthread_mutex_unlock(&swapMutex);
+        return 0;
+    }
+
+    int usedSwapFile = 0;
+    for (int i = 0; i < swapped->numPages; i++) {
+        uint8_t* destination = (uint8_t*)memory + frames[i] * pageSize;
+        t_swapPage* page = &swapped->pages[i];
+        int ok = 1;
+
+        switch (page->location) {
+            case SWAP_PAGE_SAME_FILLED:
+                memset(destination, page->fillByte, pageSize);
+                swapMetrics.tierHits++;
+                break;
+            case SWAP_PAGE_COMPRESSED:
+                if (page->dataSize == (uint32_t)pageSize)
+                    memcpy(destination, page->data, pageSize);
+                else
+                    ok = lzDecompress(page->data, page->dataSize, destination, pageSize) == pageSize;
+                swapMetrics.tierHits++;
+                break;
+            case SWAP_PAGE_FILE:
+                ok = readPageFromSwapFile(page->fileSlot, destination, pageSize);
+                swapMetrics.tierMisses++;
+                usedSwapFile = 1;
+                break;
+        }
+
+        if (!ok) {
+            log_error(memoriaLog, "## (%d) - Página %d corrupta en SWAP", proc->pid, i);
+            releaseFrames(frames, swapped->numPages);
+            free(frames);
+            free(pidKey);
+            pthread_mutex_unlock(&swapMutex);
+            return 0;
+        }
+    }
+
+    for (int i = 0; i < swapped->numPages; i++)
+        mapPageToFrame(proc, i, frames[i]);
+
+    dictionary_remove(swappedProcesses, pidKey);
+    free(pidKey);
+    destroySwappedProcess(swapped);
+
+    swapMetrics.pagesIn += proc->numPages;
+    chargeSwapOperation(usedSwapFile);
+
+    pthread_mutex_unlock(&swapMutex);
+
+    memcpy(proc->frames, frames, sizeof(int) * proc->numPages);
+    free(frames);
+    proc->suspended = 0;
+    metricAdd(&proc->metrics.swapIns, 1);
+    metricAdd(&proc->metrics.pagesSwappedIn, proc->numPages);
+
+    log_info(memoriaLog, "## (%d) - Proceso subido desde SWAP: %d páginas%s", proc->pid, proc->numPages, usedSwapFile ? " (usó swapfile)" : "");
+    logSwapMetrics();
+    return 1;
+}
+
+// Copia las métricas globales del SWAP (para el export de métricas):
+void getSwapMetrics(tSwapMetrics* out) {
+    pthread_mutex_lock(&swapMutex);
+    *out = swapMetrics;
+    pthread_mutex_unlock(&swapMutex);
+}
+
+// Descarta lo que haya en SWAP del proceso (se usa al finalizar un proceso suspendido):
+void removeProcessFromSwap(int pid) {
+    pthread_mutex_lock(&swapMutex);
+    char* pidKey = string_itoa(pid);
+    t_swappedProcess* swapped = dictionary_remove(swappedProcesses, pidKey);
+    free(pidKey);
+    if (swapped)
+        destroySwappedProcess(swapped);
+    pthread_mutex_unlock(&swapMutex);
+}
+
+void logSwapMetrics(void) {
+    pthread_mutex_lock(&swapMutex);
+    double compressionRatio = swapMetrics.storedBytesInTier ? (double)swapMetrics.rawBytesInTier / swapMetrics.storedBytesInTier : 0.0;
+    uint64_t pagesRead = swapMetrics.tierHits + swapMetrics.tierMisses;
+    double hitRate = pagesRead ? 100.0 * swapMetrics.tierHits / pagesRead : 0.0;
+
+    log_info(memoriaLog,
+             "SWAP Métricas - Tier: %zu/%d bytes; Compresión: %.2fx; Hit rate tier: %.1f%%; Páginas bajadas: %llu (uniformes %llu, comprimidas %llu, archivo %llu); Páginas subidas: %llu; Accesos a swapfile: %llu; Tiempo ahorrado: %llu ms",
+             swapMetrics.tierUsedBytes, getMemoriaConfig()->SWAP_RAM_TAMANIO,
+             compressionRatio, hitRate,
+             (unsigned long long)swapMetrics.pagesOut,
+             (unsigned long long)swapMetrics.sameFilledPages,
+             (unsigned long long)swapMetrics.compressedPages,
+             (unsigned long long)swapMetrics.filePages,
+             (unsigned long long)swapMetrics.pagesIn,
+             (unsigned long long)swapMetrics.swapFileOperations,
+             (unsigned long long)swapMetrics.savedMilliseconds);
+    pthread_mutex_unlock(&swapMutex);
+}
@@ -0,0 +1,58 @@
+#ifndef MEMORIA_SWAP_H
+#define MEMORIA_SWAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "memoriaServer.h"
+
+// Dónde quedó guardada una página que se bajó a SWAP:
+// SWAP_PAGE_SAME_FILLED es una página con todos sus bytes iguales, solo se guarda ese byte,
+// SWAP_PAGE_COMPRESSED es una página guardada en el tier comprimido en RAM,
+// SWAP_PAGE_FILE es una página que no entró en el tier y se escribió en el PATH_SWAPFILE:
+typedef enum {
+    SWAP_PAGE_SAME_FILLED,
+    SWAP_PAGE_COMPRESSED,
+    SWAP_PAGE_FILE
+} tSwapPageLocation;
+
+typedef struct {
+    tSwapPageLocation location;
+    uint8_t fillByte;
+    void* data;          // contenido comprimido (o crudo si la página no era compresible)
+    uint32_t dataSize;
+    int fileSlot;        // número de slot dentro del swapfile
+} t_swapPage;
+
+typedef struct {
+    int pid;
+    int numPages;
+    t_swapPage* pages;
+} t_swappedProcess;
+
+// Métricas globales del SWAP, se loguean después de cada operación:
+typedef struct {
+    uint64_t pagesOut;
+    uint64_t pagesIn;
+    uint64_t sameFilledPages;
+    uint64_t compressedPages;
+    uint64_t filePages;
+    uint64_t tierHits;
+    uint64_t tierMisses;
+    uint64_t rawBytesInTier;
+    uint64_t storedBytesInTier;
+    uint64_t swapFileOperations;
+    uint64_t savedMilliseconds;
+    size_t tierUsedBytes;
+} tSwapMetrics;
+
+void initSwap(void);
+void destroySwap(void);
+
+int swapOutProcess(t_memoriaProcess* proc);
+int swapInProcess(t_memoriaProcess* proc, int reservationToken);
+void removeProcessFromSwap(int pid);
+
+void logSwapMetrics(void);
+void getSwapMetrics(tSwapMetrics* out);
+
+#endif
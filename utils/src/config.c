@@ -4,6 +4,13 @@
 void configInitialize(tModule module, t_config** configFile, void** configStruct, t_log* logger){
     configCreate(module, configFile, logger);
     configGetData(module, (*configFile), configStruct, logger);
+
+    // Tiempo lógico, opcional en todos los módulos (ausente o 0: retardos reales). La CPU lleva un reloj por núcleo y la Memoria uno por conexión,
+    // porque sus hilos atienden pedidos en paralelo; Kernel e IO, uno solo (ver logicalClock.h):
+    bool logicalTime = config_has_property(*configFile, "TIEMPO_LOGICO") && config_get_int_value(*configFile, "TIEMPO_LOGICO");
+    logicalClockInit(logicalTime, module == CPU || module == MEMORIA);
+    if (logicalTime)
+        log_info(logger, "Corriendo con tiempo lógico: los retardos no se duermen (no es una simulación de eventos discretos, ver logicalClock.h).");
 }
 
 // Es la función que crea el config, guiándose por el nombre del módulo pasado.
@@ -59,9 +66,37 @@ void configGetData(tModule module, t_config* configFile, void** configStruct, t_
             cpuConfig->PUERTO_KERNEL_INTERRUPT = config_get_string_value(configFile, "PUERTO_KERNEL_INTERRUPT");
             cpuConfig->ENTRADAS_TLB = config_get_int_value(configFile, "ENTRADAS_TLB");
             cpuConfig->REEMPLAZO_TLB = config_get_string_value(configFile, "REEMPLAZO_TLB");
+            // Vías por conjunto de la TLB, opcional (0 o ausente: hasta 8 vías, o sea totalmente asociativa si ENTRADAS_TLB <= 8):
+            cpuConfig->ASOCIATIVIDAD_TLB = config_has_property(configFile, "ASOCIATIVIDAD_TLB") ? config_get_int_value(configFile, "ASOCIATIVIDAD_TLB") : 0;
+            // Cuotas por proceso, opcionales (ausente o 0: sin límite): vías de cada conjunto de la TLB y entradas de la Caché de Páginas que puede ocupar un mismo pid:
+            cpuConfig->CUOTA_TLB = config_has_property(configFile, "CUOTA_TLB") ? config_get_int_value(configFile, "CUOTA_TLB") : 0;
+            cpuConfig->CUOTA_CACHE = config_has_property(configFile, "CUOTA_CACHE") ? config_get_int_value(configFile, "CUOTA_CACHE") : 0;
+            // Entradas por nivel de la caché de tablas de páginas intermedias, opcional (ausente: 8; 0: deshabilitada):
+            cpuConfig->ENTRADAS_CACHE_TABLAS = config_has_property(configFile, "ENTRADAS_CACHE_TABLAS") ? config_get_int_value(configFile, "ENTRADAS_CACHE_TABLAS") : 8;
             cpuConfig->ENTRADAS_CACHE = config_get_int_value(configFile, "ENTRADAS_CACHE");
             cpuConfig->REEMPLAZO_CACHE = config_get_string_value(configFile, "REEMPLAZO_CACHE");
             cpuConfig->RETARDO_CACHE = config_get_int_value(configFile, "RETARDO_CACHE");
+            // Política de escritura de la Caché de Páginas, opcional: WRITE_BACK o WRITE_THROUGH (por defecto):
+            cpuConfig->ESCRITURA_CACHE = config_has_property(configFile, "ESCRITURA_CACHE") ? config_get_string_value(configFile, "ESCRITURA_CACHE") : "WRITE_THROUGH";
+            // Caché de instrucciones decodificadas, opcional: entradas (ausente o 0: deshabilitada), y si un hit simula igual el retardo
+            // del fetch a Memoria (MEMORIA, por defecto, para que los experimentos sean comparables) o no espera nada (NINGUNO):
+            cpuConfig->ENTRADAS_CACHE_INSTRUCCIONES = config_has_property(configFile, "ENTRADAS_CACHE_INSTRUCCIONES") ? config_get_int_value(configFile, "ENTRADAS_CACHE_INSTRUCCIONES") : 0;
+            cpuConfig->RETARDO_CACHE_INSTRUCCIONES = config_has_property(configFile, "RETARDO_CACHE_INSTRUCCIONES") ? config_get_string_value(configFile, "RETARDO_CACHE_INSTRUCCIONES") : "MEMORIA";
+            // Prefetch de la MMU, opcional: cuántas páginas adelantar (ausente o 0: deshabilitado), y si se traen solo las TRADUCCIONES (por defecto) o también las PAGINAS:
+            cpuConfig->PREFETCH_PAGINAS = config_has_property(configFile, "PREFETCH_PAGINAS") ? config_get_int_value(configFile, "PREFETCH_PAGINAS") : 0;
+            cpuConfig->PREFETCH_MODO = config_has_property(configFile, "PREFETCH_MODO") ? config_get_string_value(configFile, "PREFETCH_MODO") : "TRADUCCIONES";
+            // Etapas del pipeline de instrucciones, opcional: 1 (por defecto) pide cada instrucción recién cuando terminó la anterior,
+            // 2 pide la siguiente apenas se decodifica la actual, para que el fetch viaje mientras se ejecuta:
+            cpuConfig->ETAPAS_PIPELINE = config_has_property(configFile, "ETAPAS_PIPELINE") ? config_get_int_value(configFile, "ETAPAS_PIPELINE") : 1;
+            // Núcleos que levanta el proceso, opcional (ausente: 1). Cada uno se registra en el Kernel con su propio id:
+            cpuConfig->NUCLEOS = config_has_property(configFile, "NUCLEOS") ? config_get_int_value(configFile, "NUCLEOS") : 1;
+            // Bloques de código enhebrado por núcleo para las rachas de NOOP / GOTO, opcional (ausente: 16; 0: deshabilitado). Necesita la caché de instrucciones:
+            cpuConfig->BLOQUES_TRADUCIDOS = config_has_property(configFile, "BLOQUES_TRADUCIDOS") ? config_get_int_value(configFile, "BLOQUES_TRADUCIDOS") : 16;
+            // Archivo para la traza binaria por instrucción, opcional (ausente o vacío: traza apagada). Se resume con ./bin/cpu --trace-summary <archivo>:
+            cpuConfig->TRAZA_ARCHIVO = config_has_property(configFile, "TRAZA_ARCHIVO") ? config_get_string_value(configFile, "TRAZA_ARCHIVO") : NULL;
+            // Instrucciones ya decodificadas que mira el lookahead para adelantar las páginas de sus READ / WRITE, opcional (ausente o 0:
+            // deshabilitado). Necesita la caché de instrucciones, y trae solo traducciones o también páginas según PREFETCH_MODO:
+            cpuConfig->LOOKAHEAD_INSTRUCCIONES = config_has_property(configFile, "LOOKAHEAD_INSTRUCCIONES") ? config_get_int_value(configFile, "LOOKAHEAD_INSTRUCCIONES") : 0;
             cpuConfig->LOG_LEVEL = config_get_string_value(configFile, "LOG_LEVEL");
             (*configStruct) = cpuConfig;
             break;
@@ -78,6 +113,12 @@ void configGetData(tModule module, t_config* configFile, void** configStruct, t_
             memoriaConfig->LOG_LEVEL = config_get_string_value(configFile, "LOG_LEVEL");
             memoriaConfig->DUMP_PATH = config_get_string_value(configFile, "DUMP_PATH");
             memoriaConfig->PATH_INSTRUCCIONES = config_get_string_value(configFile, "PATH_INSTRUCCIONES");
+            // Las claves del tier de SWAP comprimido son opcionales, si no están el tier queda deshabilitado:
+            memoriaConfig->SWAP_RAM_TAMANIO = config_has_property(configFile, "SWAP_RAM_TAMANIO") ? config_get_int_value(configFile, "SWAP_RAM_TAMANIO") : 0;
+            memoriaConfig->SWAP_RAM_PAGINAS_UNIFORMES = config_has_property(configFile, "SWAP_RAM_PAGINAS_UNIFORMES") ? config_get_int_value(configFile, "SWAP_RAM_PAGINAS_UNIFORMES") : 0;
+            // El export periódico de métricas también es opcional (STATS_INTERVALO en milisegundos, 0 lo deshabilita):
+            memoriaConfig->STATS_INTERVALO = config_has_property(configFile, "STATS_INTERVALO") ? config_get_int_value(configFile, "STATS_INTERVALO") : 0;
+            memoriaConfig->STATS_PATH = config_has_property(configFile, "STATS_PATH") ? config_get_string_value(configFile, "STATS_PATH") : "memoria.stats";
             (*configStruct) = memoriaConfig;
             break;
         case IO:
@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include "utils.h"
+#include "logicalClock.h"
 
 // Estructura del config del Kernel:
 typedef struct{
@@ -27,9 +28,23 @@ typedef struct{
     char*   PUERTO_KERNEL_INTERRUPT;
     int     ENTRADAS_TLB;
     char*   REEMPLAZO_TLB;
+    int     ASOCIATIVIDAD_TLB;
+    int     CUOTA_TLB;
+    int     ENTRADAS_CACHE_TABLAS;
     int     ENTRADAS_CACHE;
     char*   REEMPLAZO_CACHE;
     int     RETARDO_CACHE;
+    char*   ESCRITURA_CACHE;
+    int     ENTRADAS_CACHE_INSTRUCCIONES;
+    char*   RETARDO_CACHE_INSTRUCCIONES;
+    int     CUOTA_CACHE;
+    int     PREFETCH_PAGINAS;
+    char*   PREFETCH_MODO;
+    int     ETAPAS_PIPELINE;
+    int     NUCLEOS;
+    int     BLOQUES_TRADUCIDOS;
+    char*   TRAZA_ARCHIVO;
+    int     LOOKAHEAD_INSTRUCCIONES;
     char*   LOG_LEVEL;
 } cpuConfigStruct;
 
@@ -46,6 +61,10 @@ typedef struct{
     char* LOG_LEVEL;
     char* DUMP_PATH;
     char* PATH_INSTRUCCIONES;
+    int SWAP_RAM_TAMANIO;
+    int SWAP_RAM_PAGINAS_UNIFORMES;
+    int STATS_INTERVALO;
+    char* STATS_PATH;
 } memoriaConfigStruct;
 
 // Estructura del config de IO:
@@ -0,0 +1,47 @@
+#include "histogram.h"
+
+// Los primeros HISTOGRAM_SUB_BUCKETS buckets son exactos (0..15 ns). Para un valor mayor, con su bit más alto en la posición e,
+// se toman los HISTOGRAM_SUB_BUCKET_BITS + 1 bits más altos (entre 16 y 31): el grupo lo da e y el bucket dentro del grupo, esos bits.
+static int bucketOf(uint64_t ns) {
+    if (ns < HISTOGRAM_SUB_BUCKETS)
+        return (int)ns;
+    int shift = 63 - __builtin_clzll(ns) - HISTOGRAM_SUB_BUCKET_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + (int)((ns >> shift) - HISTOGRAM_SUB_BUCKETS);
+}
+
+// Mayor valor que cae en el bucket:
+uint64_t histogram_bucket_upper(int bucket) {
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return (uint64_t)bucket;
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(bucket % HISTOGRAM_SUB_BUCKETS) + HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+void histogram_record(tLatencyHistogram* histogram, uint64_t ns) {
+    histogram->buckets[bucketOf(ns)]++;
+    histogram->count++;
+    histogram->sumNs += ns;
+    if (ns > histogram->maxNs)
+        histogram->maxNs = ns;
+}
+
+// Cota superior del percentil (el límite del bucket donde cae, nunca más que el máximo visto), en nanosegundos:
+uint64_t histogram_percentile(tLatencyHistogram* histogram, double percentile) {
+    uint64_t target = (uint64_t)(histogram->count * percentile / 100.0 + 0.5);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            uint64_t bound = histogram_bucket_upper(i);
+            return bound < histogram->maxNs ? bound : histogram->maxNs;
+        }
+    }
+    return histogram->maxNs;
+}
+
+double histogram_mean(tLatencyHistogram* histogram) {
+    return histogram->count ? (double)histogram->sumNs / histogram->count : 0.0;
+}
@@ -0,0 +1,25 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// Histograma de latencias al estilo HDR: logarítmico-lineal. Hasta 2^HISTOGRAM_SUB_BUCKET_BITS ns cada valor tiene su bucket; de ahí
+// en más cada potencia de 2 se parte en 2^HISTOGRAM_SUB_BUCKET_BITS buckets iguales, así el error relativo de un percentil es a lo sumo
+// 1/2^HISTOGRAM_SUB_BUCKET_BITS (6,25%) en todo el rango, de nanosegundos a horas, con un arreglo fijo y sin reservar memoria al registrar.
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t sumNs;
+    uint64_t maxNs;
+} tLatencyHistogram;
+
+void histogram_record(tLatencyHistogram* histogram, uint64_t ns);
+uint64_t histogram_percentile(tLatencyHistogram* histogram, double percentile);
+uint64_t histogram_bucket_upper(int bucket);
+double histogram_mean(tLatencyHistogram* histogram);
+
+#endif
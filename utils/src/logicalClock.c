@@ -0,0 +1,64 @@
+#include "logicalClock.h"
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+static bool logicalTime = false;
+static bool clockPerThread = false;
+static _Atomic uint64_t processClockNs; // reloj del proceso (modo compartido)
+static __thread uint64_t threadClockNs;  // reloj del hilo (modo por hilo)
+
+// Se llama una sola vez al leer el config, antes de levantar hilos:
+void logicalClockInit(bool enabled, bool perThread) {
+    logicalTime = enabled;
+    clockPerThread = perThread;
+}
+
+bool logicalClockEnabled(void) {
+    return logicalTime;
+}
+
+static void advanceProcessClockTo(uint64_t ns) {
+    uint64_t current = atomic_load_explicit(&processClockNs, memory_order_relaxed);
+    while (current < ns && !atomic_compare_exchange_weak_explicit(&processClockNs, &current, ns, memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+// Hora actual en nanosegundos: la lógica, o la del reloj monotónico en modo real:
+uint64_t logicalNowNs(void) {
+    if (!logicalTime) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+    }
+    return clockPerThread ? threadClockNs : atomic_load_explicit(&processClockNs, memory_order_relaxed);
+}
+
+// Llegó un paquete con la hora de quien lo mandó: si este reloj está atrás, salta hasta esa hora (nunca retrocede):
+void logicalClockObserve(uint64_t stampNs) {
+    if (!logicalTime) return;
+
+    if (clockPerThread) {
+        if (stampNs > threadClockNs)
+            threadClockNs = stampNs;
+    } else {
+        advanceProcessClockTo(stampNs);
+    }
+}
+
+// Un retardo simulado: en modo real se duerme, en modo lógico solo se adelanta el reloj:
+void simulatedSleepNs(uint64_t ns) {
+    if (!logicalTime) {
+        nanosleep(&(struct timespec){ .tv_sec = ns / 1000000000ull, .tv_nsec = ns % 1000000000ull }, NULL);
+        return;
+    }
+
+    if (clockPerThread)
+        threadClockNs += ns;
+    else
+        atomic_fetch_add_explicit(&processClockNs, ns, memory_order_relaxed);
+}
+
+void simulatedSleepMs(uint64_t ms) {
+    simulatedSleepNs(ms * 1000000ull);
+}
@@ -0,0 +1,27 @@
+#ifndef LOGICAL_CLOCK_H
+#define LOGICAL_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Reloj de la simulación. En modo real (por defecto) los retardos se duermen y nanoseconds() es el reloj monotónico.
+// Con TIEMPO_LOGICO=1 en el config de un módulo, los retardos no se duermen: solo adelantan un reloj lógico, y cada paquete
+// que sale lleva la hora lógica de quien lo manda. Al recibirlo, el reloj del receptor salta a esa hora si estaba atrás
+// (relojes de Lamport), así el tiempo pasa de un módulo a otro junto con los mensajes sin que nadie espere de verdad.
+// No es una simulación de eventos discretos: no hay cola de eventos ni nadie que los libere en orden de hora. Los hilos siguen
+// corriendo en el orden real en que el sistema los planifica, así que un retardo (un IO) termina apenas se lo pide, aunque otro módulo
+// tenga eventos de hora anterior todavía sin mandar, y en un reloj compartido los retardos de hilos concurrentes se suman en lugar de
+// solaparse. Por eso lo que depende de cuánto tiempo pasó se decide comparando horas de los paquetes y no con un timer (la suspensión
+// del Kernel, ver mediumTermScheduling.c). Sirve para correr rápido y medir duraciones en hora lógica, no para reproducir
+// el orden temporal de la simulación con retardos reales.
+// Un reloj puede ser por hilo (CPU: cada núcleo tiene su línea de tiempo; Memoria: cada conexión) o uno solo para el proceso (Kernel, IO).
+// Todos los módulos tienen que usar el mismo modo: un módulo en tiempo real no le pone hora a sus paquetes.
+
+void logicalClockInit(bool enabled, bool perThread);
+bool logicalClockEnabled(void);
+uint64_t logicalNowNs(void);
+void logicalClockObserve(uint64_t stampNs);
+void simulatedSleepNs(uint64_t ns);
+void simulatedSleepMs(uint64_t ms);
+
+#endif
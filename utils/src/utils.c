@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "logicalClock.h"
 #include <string.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -33,6 +34,7 @@ tBuffer* createBuffer(){
 tPackage* createPackage(tOperationCode operationCode){
     tPackage* package = malloc(sizeof(tPackage));
     package->operationCode = operationCode;
+    package->timestamp = 0;
     package->buffer = createBuffer();
     return package;
 }
@@ -56,22 +58,24 @@ void addToPackage(tPackage *package, void* thing, uint32_t size){
 // Envía el paquete utilizando el socket de conexión pasado como parámetro.
 // LA FUNCIÓN AUTOMÁTICAMENTE DESTRUYE EL PAQUETE, ESTO SE PUEDE CAMBIAR SI RESULTA INCONVENIENTE:
 void sendPackage(tPackage *package, int connectionSocket){
+    package->timestamp = logicalClockEnabled() ? logicalNowNs() : 0;
     void* finalStream = serializedPackage(package);
     
-    send(connectionSocket, finalStream, package->buffer->size + 2 * sizeof(uint32_t), 0);
+    send(connectionSocket, finalStream, package->buffer->size + PACKAGE_HEADER_SIZE, 0);
 
     free(finalStream);
     destroyPackage(package);
 }
 
 // Retorna un puntero un stream o flujo (es un puntero a void), con toda la informacion del paquete serializada.
-// Primero estará el código de operación, luego el tamaño de memoria que ocupa el stream, y luego el stream mismo:
+// Primero estará el código de operación, luego el timestamp, luego el tamaño de memoria que ocupa el stream, y luego el stream mismo:
 void* serializedPackage(tPackage *package){
-    void* stream = malloc(package->buffer->size + 2 * sizeof(uint32_t));
+    void* stream = malloc(package->buffer->size + PACKAGE_HEADER_SIZE);
 
     memcpy(stream, &(package->operationCode), sizeof(uint32_t));
-    memcpy(stream + sizeof(uint32_t), &(package->buffer->size), sizeof(uint32_t));
-    memcpy(stream + 2 * sizeof(uint32_t), package->buffer->stream, package->buffer->size);
+    memcpy(stream + sizeof(uint32_t), &(package->timestamp), sizeof(uint64_t));
+    memcpy(stream + sizeof(uint32_t) + sizeof(uint64_t), &(package->buffer->size), sizeof(uint32_t));
+    memcpy(stream + PACKAGE_HEADER_SIZE, package->buffer->stream, package->buffer->size);
 
     return stream;
 }
@@ -110,10 +114,18 @@ tPackage* receivePackage(int connectionSocket){
     tPackage* package = createPackage(operationCode);
     destroyBuffer(package->buffer);
 
+    if (recv(connectionSocket, &package->timestamp, sizeof(uint64_t), MSG_WAITALL) != sizeof(uint64_t)) {
+        printf("Conexión cerrada por el otro extremo antes de recibir el timestamp del paquete\n");
+        free(package);
+        return NULL;
+    }
+
     package->buffer = receiveBuffer(connectionSocket);
     if (!package->buffer)
         return NULL;
 
+    // En tiempo lógico, el reloj del que recibe no puede quedar antes de la hora en que se mandó el paquete
+    logicalClockObserve(package->timestamp);
     return package;
 }
 
@@ -225,8 +237,8 @@ uint64_t extractUint64ElementFromList(t_list* list, int index){
 }
 
 
-long long milliseconds(){
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+// Nanosegundos del reloj de la simulación: CLOCK_MONOTONIC (que en Linux se lee por el vDSO, sin entrar al kernel),
+// o el lógico si el módulo corre con TIEMPO_LOGICO. Todas las mediciones de tiempo de los módulos salen de acá:
+uint64_t nanoseconds(void){
+    return logicalNowNs();
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <time.h>
+#include "histogram.h"
 
 // Enumerado para identificar los módulos:
 typedef enum{
@@ -43,18 +44,24 @@ typedef enum{
     KERNEL_TO_MEMORY_REQUEST_TO_LOAD_PROCESS,
     KERNEL_TO_MEMORY_REQUEST_TO_REMOVE_PROCESS,
     KERNEL_TO_MEMORY_DUMP_REQUEST,
+    KERNEL_TO_MEMORY_REQUEST_TO_SUSPEND_PROCESS,
+    KERNEL_TO_MEMORY_RESERVE_SPACE,
+    KERNEL_TO_MEMORY_RELEASE_RESERVATION,
 
     MEMORY_TO_KERNEL_PROCESS_LOAD_OK,
     MEMORY_TO_KERNEL_PROCESS_LOAD_FAIL,
     MEMORY_TO_KERNEL_PROCESS_REMOVED,
     MEMORY_TO_KERNEL_DUMP_COMPLETED,
     MEMORY_TO_KERNEL_DUMP_FAIL,
+    MEMORY_TO_KERNEL_PROCESS_SUSPENDED,
+    MEMORY_TO_KERNEL_RESERVATION_RESULT,
 
     CPU_DISPATCH_TO_KERNEL_EXIT,
     CPU_DISPATCH_TO_KERNEL_IO,
     CPU_DISPATCH_TO_KERNEL_INIT_PROC,
     CPU_DISPATCH_TO_KERNEL_DUMP_MEMORY,
     CPU_DISPATCH_TO_KERNEL_PREEMPTION_COMPLETED,
+    CPU_DISPATCH_TO_KERNEL_SEG_FAULT,
 
     IO_TO_KERNEL_COMPLETED,
 
@@ -64,25 +71,49 @@ typedef enum{
     MEMORIA_TO_CPU_READ_RESPONSE,
     CPU_TO_MEMORIA_WRITE,
     MEMORIA_TO_CPU_WRITE_ACK,
+    CPU_TO_MEMORIA_WRITE_PAGES,
     KERNEL_TO_CPU_INIT_PROCESS,
 
     CPU_TO_MEMORIA_GET_PAGE_TABLE_ENTRY,
     MEMORIA_TO_CPU_PAGE_TABLE_ENTRY, // La respuesta de memoria
-    GET_MEMORIA_FREE_SPACE
+    GET_MEMORIA_FREE_SPACE,
+    MEMORIA_STATS,
+
+    MEMORIA_TO_CPU_SHOOTDOWN,    // Invalidación de traducciones y páginas en las CPUs, por su conexión de interrupt con Memoria
+    CPU_TO_MEMORIA_SHOOTDOWN_ACK,
+
+    CPU_TO_MEMORIA_BATCH,        // Varios pedidos independientes de la MMU en un solo mensaje (ver tMemoriaBatchKind)
+    MEMORIA_TO_CPU_BATCH_RESPONSE
 } tOperationCode;
 
+// Un MEMORIA_TO_CPU_SHOOTDOWN lleva [id | pid | primero | cantidad] e invalida las páginas [primero, primero + cantidad) del pid.
+// La CPU contesta CPU_TO_MEMORIA_SHOOTDOWN_ACK con el id.
+
+// Pedidos que puede llevar un CPU_TO_MEMORIA_BATCH, que empieza con [pid] y sigue con cada pedido: [tipo | tabla (uint64) | nivel | entrada]
+// para una entrada de tabla de páginas, [tipo | dirección física | tamaño] para una lectura, y [tipo | dirección física | tamaño | datos]
+// para una escritura. MEMORIA_TO_CPU_BATCH_RESPONSE trae un elemento por pedido: la entrada (uint64), los datos leídos, o un 0 (uint32):
+typedef enum {
+    MEMORIA_BATCH_PAGE_TABLE_ENTRY,
+    MEMORIA_BATCH_READ,
+    MEMORIA_BATCH_WRITE
+} tMemoriaBatchKind;
+
 // Estructura del Buffer que hay dentro de cada Paquete:
 typedef struct{
     uint32_t size;
     void* stream;
 } tBuffer;
 
-// Estructura de un Paquete:
+// Estructura de un Paquete. timestamp es la hora lógica de quien lo mandó (0 en modo de tiempo real, ver logicalClock.h):
 typedef struct{
     tOperationCode operationCode;
+    uint64_t timestamp;
     tBuffer *buffer;
 } tPackage;
 
+// Encabezado de un paquete serializado: código de operación, timestamp y tamaño del stream
+#define PACKAGE_HEADER_SIZE (2 * sizeof(uint32_t) + sizeof(uint64_t))
+
 // Estructura de Contexto de Ejecucion:
 typedef struct {
     int pid;
@@ -102,11 +133,18 @@ typedef enum {
     UNKNOWN
 } tInstructionType;
 
-// Estructura para una instrucción decodificada
+#define INSTRUCTION_MAX_PARAMS 5
+#define INSTRUCTION_MAX_LENGTH 256
+
+// Estructura para una instrucción decodificada. La arma quien llama (no usa memoria dinámica): text es una copia de la instrucción
+// con los separadores cambiados por '\0', params apunta a cada parámetro dentro de text, y args tiene ya convertidos a entero
+// los parámetros que la operación usa como números (direcciones, tamaños, tiempos):
 typedef struct {
     tInstructionType operation;
     int total_params;
-    char* params[5];
+    char* params[INSTRUCTION_MAX_PARAMS];
+    int64_t args[INSTRUCTION_MAX_PARAMS];
+    char text[INSTRUCTION_MAX_LENGTH];
 } tDecodedInstruction;
 
 char* getModuleName(tModule module);
@@ -132,6 +170,6 @@ int extractIntElementFromList(t_list* list, int index);
 
 uint64_t extractUint64ElementFromList(t_list* list, int index);
 
-long long milliseconds();
+uint64_t nanoseconds(void);
 
 #endif
\ No newline at end of file